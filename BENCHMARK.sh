@@ -0,0 +1,40 @@
+#!/bin/bash
+# Compare the encoders on PB files (default: example/*.pbf), extra options are passed to Encoder
+# usage: ./BENCHMARK.sh [-o "Encoder options"] [file ...]
+
+ENCODERS=("1 Warners" "2 GenArc" "3 Hybrid" "4 SWC" "5 GT" "6 MixedRadix" "7 BinaryMerge" "8 Watchdog")
+
+if [ ! -f "./Encoder" ]
+then
+    echo "Encoder not found, run ./INSTALL.sh first"
+    exit 1
+fi
+
+options=""
+if [ "$1" == "-o" ]
+then
+    options=$2
+    shift 2
+fi
+
+files=("$@")
+if [ ${#files[@]} -eq 0 ]
+then
+    files=(example/*.pbf)
+fi
+
+output=$(mktemp)
+printf "%-30s %-12s %12s %12s %10s\n" "file" "encoder" "aux vars" "clauses" "seconds"
+for file in "${files[@]}"
+do
+    for encoder in "${ENCODERS[@]}"
+    do
+        set -- $encoder
+        stats=$(./Encoder -I "$file" -O "$output" --ed $1 $options)
+        auxVars=$(echo "$stats" | grep "^\* aux vars" | awk '{print $4}')
+        clauses=$(echo "$stats" | grep "^\* clauses" | awk '{print $3}')
+        seconds=$(echo "$stats" | grep "^\* encode seconds" | awk '{print $4}')
+        printf "%-30s %-12s %12s %12s %10s\n" "$(basename $file)" "$2" "$auxVars" "$clauses" "$seconds"
+    done
+done
+rm -f "$output"
@@ -6,12 +6,126 @@ void Encoder::addClause(vector<Int> &clause) {
     clauseCnt++;
 }
 
+void Encoder::addGate(GateType type, Int output, const vector<Int> &inputs) {
+    gates.push_back({type, output, (Int)gateOperands.size(), (Int)inputs.size()});
+    gateOperands.insert(gateOperands.end(), inputs.begin(), inputs.end());
+    switch(type) {
+        case GateType::And:
+        case GateType::Or:       clauseCnt += inputs.size() + 1; break;
+        case GateType::Xor:      clauseCnt += 4; break;
+        case GateType::Xor3:     clauseCnt += 8; break;
+        case GateType::Majority: clauseCnt += 6; break;
+        case GateType::Ite:
+        case GateType::OrAnd:    clauseCnt += 4; break;
+        case GateType::Merge:       // one clause up per pair, one down per gap between pairs
+            clauseCnt += inputs.size() / 2 + (inputs[0] != 0);
+            for(Int k = 1; k < inputs.size(); k += 2) clauseCnt += inputs[k] != 0;
+            break;
+    }
+    if(DEBUG) {
+        vector<vector<Int> > gateClause;
+        gateClauses(gates.back(), gateClause);
+        for(const vector<Int> &clause : gateClause) util::printClause(clause);
+    }
+}
+
+void Encoder::gateClauses(const Gate &gate, vector<vector<Int> > &gateClause) const {
+    const Int *in = gateOperands.data() + gate.firstInput;
+    Int o = gate.output;
+    gateClause.clear();
+    switch(gate.type) {
+        case GateType::And:         // o <--> in[0] /\ in[1] /\ ...
+        case GateType::Or: {        // o <--> in[0] \/ in[1] \/ ... is the and of the negations, negated
+            Int sign = gate.type == GateType::And ? 1 : -1;
+            vector<Int> longClause = {sign * o};
+            for(Int k = 0; k < gate.inputCnt; k++) {
+                gateClause.push_back({-sign * o, sign * in[k]});
+                longClause.push_back(-sign * in[k]);
+            }
+            gateClause.push_back(longClause);
+            break;
+        }
+        case GateType::Xor:
+            gateClause = {{-o, in[0], in[1]}, {-o, -in[0], -in[1]}, {o, -in[0], in[1]}, {o, in[0], -in[1]}};
+            break;
+        case GateType::Xor3:
+            gateClause = {
+                {-o, in[0], in[1], in[2]}, {-o, in[0], -in[1], -in[2]}, {-o, -in[0], in[1], -in[2]}, {-o, -in[0], -in[1], in[2]},
+                {o, -in[0], in[1], in[2]}, {o, in[0], -in[1], in[2]}, {o, in[0], in[1], -in[2]}, {o, -in[0], -in[1], -in[2]}};
+            break;
+        case GateType::Majority:
+            gateClause = {
+                {-o, in[0], in[1]}, {-o, in[0], in[2]}, {-o, in[1], in[2]},
+                {o, -in[0], -in[1]}, {o, -in[0], -in[2]}, {o, -in[1], -in[2]}};
+            break;
+        case GateType::Ite:         // o <--> in[0] ? in[1] : in[2]
+            gateClause = {{-o, -in[0], in[1]}, {-o, in[0], in[2]}, {o, -in[0], -in[1]}, {o, in[0], -in[2]}};
+            break;
+        case GateType::OrAnd:       // o <--> in[0] \/ (in[1] /\ in[2])
+            gateClause = {{o, -in[0]}, {o, -in[1], -in[2]}, {-o, in[0], in[1]}, {-o, in[0], in[2]}};
+            break;
+        case GateType::Merge: {     // o <--> some l_k /\ r_k, in = l_1 r_1 l_2 r_2 ..., 0 is true
+            // l_k are outputs of one sorted counter going up and r_k of the other going down, so
+            // o fails exactly when l_{k+1} and r_k both fail for some k (l_1 and r_K at the ends)
+            Int pairCnt = gate.inputCnt / 2;
+            if(in[0] != 0) gateClause.push_back({-o, in[0]});
+            for(Int k = 0; k < pairCnt; k++) {
+                vector<Int> up = {o}, down = {-o};
+                if(in[2 * k] != 0) up.push_back(-in[2 * k]);
+                if(in[2 * k + 1] != 0) up.push_back(-in[2 * k + 1]);
+                gateClause.push_back(up);
+                if(in[2 * k + 1] == 0) continue;
+                if(k + 1 < pairCnt) down.push_back(in[2 * k + 2]);
+                down.push_back(in[2 * k + 1]);
+                gateClause.push_back(down);
+            }
+            break;
+        }
+    }
+}
+
+// plain clauses, then every gate expanded. With xorOutput, o <--> in[0] xor ... is the
+// extended DIMACS line "x -o in[0] ... 0", whose literals must xor to true
+void Encoder::printClauses(std::ofstream &outfile) const {
+    for(const vector<Int> &clause : clauses) {
+        for(Int literal : clause) {
+            outfile << literal << " ";
+        }
+        outfile << "0\n";
+    }
+    vector<vector<Int> > gateClause;
+    for(const Gate &gate : gates) {
+        if(xorOutput && (gate.type == GateType::Xor || gate.type == GateType::Xor3)) {
+            outfile << "x " << -gate.output;
+            for(Int k = 0; k < gate.inputCnt; k++) outfile << " " << gateOperands[gate.firstInput + k];
+            outfile << " 0\n";
+            continue;
+        }
+        gateClauses(gate, gateClause);
+        for(const vector<Int> &clause : gateClause) {
+            for(Int literal : clause) {
+                outfile << literal << " ";
+            }
+            outfile << "0\n";
+        }
+    }
+}
+
 Int Encoder::getNewAuxVar() {
     return ++varCnt;
 }
 
-void Encoder::printWeightClauseMC20(std::ofstream &outfile) const {
-    for(Int x = 1; x <= varCnt; x++) {
+Int Encoder::getFalseVar() {    // one forced-false var for every constant, its negation is true
+    if(falseVar == 0) {
+        falseVar = getNewAuxVar();
+        vector<Int> tmpClause = {-falseVar};
+        addClause(tmpClause);
+    }
+    return falseVar;
+}
+
+void Encoder::printWeightClauseMC20(std::ofstream &outfile, Int weightedVarCnt) const {   // vars 1..weightedVarCnt
+    for(Int x = 1; x <= weightedVarCnt; x++) {
         Float weight;
         weight = literalWeights.find(x)!=literalWeights.end() ? literalWeights.at(x) : 1;
         outfile << "w " << x << " " << weight << std::endl;
@@ -32,6 +146,27 @@ void Encoder::printWeightClauseMC21(std::ofstream &outfile) const {
     }
 }
 
+Int Encoder::outputClauseCnt() const {    // an x line stands for the 4 or 8 clauses of its gate
+    Int cnt = clauseCnt;
+    for(const Gate &gate : gates) {
+        if(!xorOutput) break;
+        if(gate.type == GateType::Xor) cnt -= 3;
+        if(gate.type == GateType::Xor3) cnt -= 7;
+    }
+    return cnt;
+}
+
+// every aux var is a function of the original vars 1..apparentVarCnt, so they are an
+// independent support, and projecting on them keeps the count
+void Encoder::printIndependentSupport(std::ofstream &outfile, const string &prefix) const {
+    if(!independentSupport) return;
+    for(Int first = 1; first <= apparentVarCnt; first += INDEPENDENT_SUPPORT_LINE_SIZE) {
+        outfile << prefix;
+        for(Int x = first; x <= apparentVarCnt && x < first + INDEPENDENT_SUPPORT_LINE_SIZE; x++) outfile << " " << x;
+        outfile << " 0\n";
+    }
+}
+
 void Encoder::printCnfMC20(const string &filePath) const {
     std::ofstream outfile(filePath);
     if(!outfile.is_open()) {
@@ -44,17 +179,13 @@ void Encoder::printCnfMC20(const string &filePath) const {
         case PBWeightFormat::UNWEIGHTED : problemType = "cnf"; break;
         case PBWeightFormat::WEIGHTED   : problemType = "wcnf"; break; 
     }
-    outfile << "p " << problemType << " " << varCnt << " " << clauseCnt << "\n";
+    outfile << "p " << problemType << " " << varCnt << " " << outputClauseCnt() << "\n";
+    printIndependentSupport(outfile, "c ind");
 
-    for(Int i = 0; i < clauseCnt; i++) {
-        for(Int literal : clauses[i]) {
-            outfile << literal << " ";
-        }
-        outfile << "0" << std::endl;
-    }
+    printClauses(outfile);
 
     if(weightFormat == PBWeightFormat::WEIGHTED) {
-        printWeightClauseMC20(outfile);
+        printWeightClauseMC20(outfile, varCnt);
     }
 
     outfile.close();
@@ -72,17 +203,115 @@ void Encoder::printCnfMC21(const string &filePath) const {
     //     case PBWeightFormat::UNWEIGHTED : problemType = "cnf"; break;
     //     case PBWeightFormat::WEIGHTED   : problemType = "wcnf"; break; 
     // }
-    outfile << "p " << problemType << " " << varCnt << " " << clauseCnt << "\n";
+    outfile << "p " << problemType << " " << varCnt << " " << outputClauseCnt() << "\n";
+    printIndependentSupport(outfile, "c p show");
 
-    for(Int i = 0; i < clauseCnt; i++) {
-        for(Int literal : clauses[i]) {
-            outfile << literal << " ";
+    printClauses(outfile);
+
+    if(weightFormat == PBWeightFormat::WEIGHTED) {
+        printWeightClauseMC21(outfile);
+    }
+
+    outfile.close();
+}
+
+// Binary AIGER: the original vars are the first inputs, followed by the aux vars no gate defines
+// (registers, totalizer outputs, ...), and the single output is the and of all plain clauses.
+// Gates become and-inverter structures, built in the order they were recorded, which is
+// topological since a gate is only requested once its inputs exist. The forced-false var is the
+// constant 0. Aux inputs are functions of the original ones wherever the output holds, so the
+// count of satisfying inputs is the model count
+void Encoder::printAiger(const string &filePath) const {
+    std::ofstream outfile(filePath, std::ios::binary);
+    if(!outfile.is_open()) {
+        util::showError(filePath + " can not open");
+    }
+
+    // the original vars are the inputs, aux vars are gate outputs or constants forced by a unit clause
+    vector<bool> gateDefined(varCnt + 1, false), unitSkipped(clauses.size(), false);
+    for(const Gate &gate : gates) gateDefined[gate.output] = true;
+    vector<Int> varLiteral(varCnt + 1, -1);     // AIGER literal of each var, 2 * index (+ 1 negated)
+    varLiteral[0] = 1;                          // operand 0 is true in merge gates
+    Int inputCnt = apparentVarCnt;
+    for(Int v = 1; v <= inputCnt; v++) varLiteral[v] = 2 * v;
+    for(Int j = 0; j < clauses.size(); j++) {
+        if(clauses[j].size() != 1) continue;
+        Int v = std::abs(clauses[j][0]);
+        if(v <= inputCnt || gateDefined[v] || varLiteral[v] >= 0) continue;
+        varLiteral[v] = clauses[j][0] < 0 ? 0 : 1;
+        unitSkipped[j] = true;
+    }
+    for(Int v = inputCnt + 1; v <= varCnt; v++) {
+        if(!gateDefined[v] && varLiteral[v] < 0) util::showError("aux var " + to_string(v) + " is not defined by a gate");
+    }
+    auto literalOf = [&](Int literal) {
+        Int aigLiteral = varLiteral[std::abs(literal)];
+        if(aigLiteral < 0) util::showError("var " + to_string(std::abs(literal)) + " is used before its gate");
+        return literal < 0 ? aigLiteral ^ 1 : aigLiteral;
+    };
+
+    vector<Pair<Int, Int> > ands;               // (rhs0, rhs1) of and number k, whose lhs is 2 * (I + k + 1)
+    std::map<Pair<Int, Int>, Int> andTable;
+    auto andOf = [&](Int a, Int b) {
+        if(a < b) std::swap(a, b);
+        if(b == 0 || a == (b ^ 1)) return (Int)0;
+        if(b == 1 || a == b) return a;
+        auto found = andTable.find({a, b});
+        if(found != andTable.end()) return found->second;
+        ands.push_back({a, b});
+        Int lhs = 2 * (inputCnt + ands.size());
+        andTable[{a, b}] = lhs;
+        return lhs;
+    };
+    auto orOf = [&](Int a, Int b) { return andOf(a ^ 1, b ^ 1) ^ 1; };
+    auto xorOf = [&](Int a, Int b) { return andOf(andOf(a, b) ^ 1, andOf(a ^ 1, b ^ 1) ^ 1); };
+
+    for(const Gate &gate : gates) {
+        vector<Int> in(gate.inputCnt);
+        for(Int k = 0; k < gate.inputCnt; k++) in[k] = literalOf(gateOperands[gate.firstInput + k]);
+        Int out = 1;
+        switch(gate.type) {
+            case GateType::And:      for(Int a : in) out = andOf(out, a); break;
+            case GateType::Or:       out = 0; for(Int a : in) out = orOf(out, a); break;
+            case GateType::Xor:      out = xorOf(in[0], in[1]); break;
+            case GateType::Xor3:     out = xorOf(xorOf(in[0], in[1]), in[2]); break;
+            case GateType::Majority: out = orOf(andOf(in[0], in[1]), andOf(in[2], orOf(in[0], in[1]))); break;
+            case GateType::Ite:      out = orOf(andOf(in[0], in[1]), andOf(in[0] ^ 1, in[2])); break;
+            case GateType::OrAnd:    out = orOf(in[0], andOf(in[1], in[2])); break;
+            case GateType::Merge:
+                out = 0;
+                for(Int k = 0; k + 1 < in.size(); k += 2) out = orOf(out, andOf(in[k], in[k + 1]));
+                break;
         }
-        outfile << "0" << std::endl;
+        varLiteral[gate.output] = out;
     }
 
+    Int root = 1;
+    for(Int j = 0; j < clauses.size(); j++) {
+        if(unitSkipped[j]) continue;
+        Int satisfied = 0;
+        for(Int literal : clauses[j]) satisfied = orOf(satisfied, literalOf(literal));
+        root = andOf(root, satisfied);
+    }
+
+    outfile << "aig " << inputCnt + ands.size() << " " << inputCnt << " 0 1 " << ands.size() << "\n";
+    outfile << root << "\n";
+    for(Int k = 0; k < ands.size(); k++) {
+        Int lhs = 2 * (inputCnt + k + 1);
+        for(Int delta : {lhs - ands[k].first, ands[k].first - ands[k].second}) {
+            while(delta & ~(Int)0x7f) {
+                outfile.put((char)((delta & 0x7f) | 0x80));
+                delta >>= 7;
+            }
+            outfile.put((char)delta);
+        }
+    }
+    for(Int i = 0; i < inputCnt; i++) outfile << "i" << i << " x" << i + 1 << "\n";
+    outfile << "o0 formula\n";
+
     if(weightFormat == PBWeightFormat::WEIGHTED) {
-        printWeightClauseMC21(outfile);
+        outfile << "c\n";
+        printWeightClauseMC20(outfile, inputCnt);
     }
 
     outfile.close();
@@ -92,6 +321,60 @@ void Encoder::printCnf(const string &filepath, OutputFormat outputFormat) const
     switch(outputFormat){
         case OutputFormat::MC20: printCnfMC20(filepath); break;
         case OutputFormat::MC21: printCnfMC21(filepath); break;
+        case OutputFormat::AIGER: printAiger(filepath); break;
+    }
+}
+
+void Encoder::printStats() const {
+    util::printThinLine();
+    util::printRow("apparent vars", apparentVarCnt);
+    util::printRow("aux vars", varCnt - apparentVarCnt);
+    util::printRow("clauses", clauseCnt);
+    util::printRow("encode seconds", encodeSeconds);
+    util::printThinLine();
+}
+
+// lowerLimit <= sum ax <= limit, by default as sum ax <= limit and sum a(-x) <= sum a - lowerLimit
+void Encoder::encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    vector<Int> inverseVariable(variable), inverseCoefficient(coefficient);
+    Int inverseLimit = lowerLimit, sum = 0;
+    for(Int coef : coefficient) sum += coef;
+
+    if(limit < sum) encodeConstraint(variable, coefficient, limit);     // else only the lower bound is left
+    util::inverseConstraint(inverseVariable, inverseCoefficient, inverseLimit);
+    encodeConstraint(inverseVariable, inverseCoefficient, inverseLimit);
+}
+
+// the largest value an encoding of lowerLimit <= sum ax <= limit has to tell apart;
+// a limit at or above the sum is never compared with
+Int Encoder::comparedBound(Int sum, Int lowerLimit, Int limit) {
+    return limit < sum ? limit : lowerLimit;
+}
+
+// sum ax in [lowerLimit, limit]  <==>  sum a(-x) in [sum - limit, sum - lowerLimit]. Counters, totalizers
+// and saturated adders all grow with the bound they compare with, so the side with the smaller one wins
+bool Encoder::preferComplement(Int sum, Int lowerLimit, Int limit) {
+    return comparedBound(sum, std::max(sum - limit, (Int)0), sum - lowerLimit) < comparedBound(sum, lowerLimit, limit);
+}
+
+void Encoder::encodeConstraints(const vector<vector<Int> > &variables, const vector<vector<Int> > &coefficients, const vector<Int> &lowerLimits, const vector<Int> &limits) {
+    for(Int i = 0; i < variables.size(); i++) {
+        const vector<Int> &coefficient = coefficients.at(i);
+        vector<Int> variable(variables.at(i));
+        Int lowerLimit = lowerLimits.at(i), limit = limits.at(i);
+        Int sum = 0;
+        for(Int coef : coefficient) sum += coef;
+        if(preferComplement(sum, lowerLimit, limit)) {
+            for(Int &x : variable) x = -x;
+            Int complementLimit = sum - lowerLimit;
+            lowerLimit = std::max(sum - limit, (Int)0);
+            limit = complementLimit;
+        }
+        if(lowerLimit > 0) {
+            encodeRangeConstraint(variable, coefficient, lowerLimit, limit);
+        } else {
+            encodeConstraint(variable, coefficient, limit);
+        }
     }
 }
 
@@ -99,186 +382,1082 @@ void Encoder::encodePbf(const Pbf &pbf) {
     const vector<vector<Int> > &variables = pbf.getVariables();
     const vector<vector<Int> > &coefficients = pbf.getCoefficients();
     const vector<Int> &limits = pbf.getLimits();
-    varCnt = pbf.getApparentVarCount();
+    const vector<Int> &lowerLimits = pbf.getLowerLimits();
+    TimePoint encodeStartTime = util::getTimePoint();
+    varCnt = apparentVarCnt = pbf.getApparentVarCount();
     clauseCnt = 0;
 
+    vector<vector<Int> > restVariables, restCoefficients;
+    vector<Int> restLowerLimits, restLimits;
     for(Int i = 0; i < variables.size(); i++) {
-        encodeConstraint(variables.at(i), coefficients.at(i), limits.at(i));
+        if(encodeSpecialConstraint(variables.at(i), coefficients.at(i), lowerLimits.at(i), limits.at(i))) continue;
+        restVariables.push_back(variables.at(i));
+        restCoefficients.push_back(coefficients.at(i));
+        restLowerLimits.push_back(lowerLimits.at(i));
+        restLimits.push_back(limits.at(i));
     }
+    encodeConstraints(restVariables, restCoefficients, restLowerLimits, restLimits);
+    encodeSeconds = util::getSeconds(encodeStartTime);
 
     weightFormat = pbf.getWeightFormat();
     literalWeights = pbf.getLiteralWeights();
 }
 
-void WarnersEncoder::encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit) {
-    Int left = 0, right = variable.size() - 1;
+// Structural hashing: the inputs are put in a canonical form (sorted, xor inputs positive with
+// the parity moved to the output, a positive ite selector), gates that are a constant or one of
+// their inputs are folded, and a gate equal to an earlier one anywhere in the formula gets its
+// output back. Every aux var is still a function of its inputs, so the count is unchanged
+Int Encoder::defineGate(GateType type, vector<Int> inputs) {
+    Int constant = falseVar;        // 0 if no input can be a constant yet
+    bool negated = false;
+    switch(type) {
+        case GateType::And:
+        case GateType::Or: {
+            Int absorbing = type == GateType::And ? constant : -constant;
+            vector<Int> kept;
+            for(Int input : inputs) {
+                if(constant != 0 && input == absorbing) return absorbing;
+                if(constant == 0 || input != -absorbing) kept.push_back(input);
+            }
+            std::sort(kept.begin(), kept.end());
+            kept.erase(std::unique(kept.begin(), kept.end()), kept.end());
+            for(Int input : kept) {
+                if(std::binary_search(kept.begin(), kept.end(), -input)) return type == GateType::And ? getFalseVar() : -getFalseVar();
+            }
+            if(kept.empty()) return type == GateType::And ? -getFalseVar() : getFalseVar();
+            if(kept.size() == 1) return kept.front();
+            inputs = kept;
+            break;
+        }
+        case GateType::Xor:
+        case GateType::Xor3: {
+            vector<Int> odd;        // inputs left after equal pairs cancel
+            for(Int &input : inputs) {
+                if(input < 0) {
+                    input = -input;
+                    negated = !negated;
+                }
+            }
+            std::sort(inputs.begin(), inputs.end());
+            for(Int input : inputs) {
+                if(input == constant) continue;
+                if(!odd.empty() && odd.back() == input) odd.pop_back();
+                else odd.push_back(input);
+            }
+            if(odd.empty()) return negated ? -getFalseVar() : getFalseVar();
+            if(odd.size() == 1) return negated ? -odd.front() : odd.front();
+            type = odd.size() == 2 ? GateType::Xor : GateType::Xor3;
+            inputs = odd;
+            break;
+        }
+        case GateType::Majority:
+            for(Int i = 0; i < 3; i++) {
+                for(Int j = i + 1; j < 3; j++) {
+                    if(inputs[i] == inputs[j]) return inputs[i];
+                    if(inputs[i] == -inputs[j]) return inputs[3 - i - j];
+                }
+            }
+            for(Int i = 0; constant != 0 && i < 3; i++) {
+                if(inputs[i] == constant || inputs[i] == -constant) {
+                    vector<Int> rest = {inputs[(i + 1) % 3], inputs[(i + 2) % 3]};
+                    return defineGate(inputs[i] == constant ? GateType::And : GateType::Or, rest);
+                }
+            }
+            std::sort(inputs.begin(), inputs.end());
+            break;
+        case GateType::Ite: {
+            Int x = inputs[0], hi = inputs[1], lo = inputs[2];
+            if(x < 0) {
+                x = -x;
+                std::swap(hi, lo);
+            }
+            if(hi == lo || x == constant) return lo;
+            if(constant != 0) {
+                if(hi == constant) return defineGate(GateType::And, {-x, lo});
+                if(hi == -constant) return defineGate(GateType::Or, {x, lo});
+                if(lo == constant) return defineGate(GateType::And, {x, hi});
+                if(lo == -constant) return defineGate(GateType::Or, {-x, hi});
+            }
+            inputs = {x, hi, lo};
+            break;
+        }
+        case GateType::OrAnd: {
+            Int a = inputs[0], b = std::min(inputs[1], inputs[2]), c = std::max(inputs[1], inputs[2]);
+            if(a == b || a == c || b == -c) return a;
+            if(b == c || a == -b) return defineGate(GateType::Or, {a, c});    // a \/ (-a /\ c) = a \/ c
+            if(a == -c) return defineGate(GateType::Or, {a, b});
+            if(constant != 0) {
+                if(a == constant) return defineGate(GateType::And, {b, c});
+                if(a == -constant) return a;
+                if(b == constant || c == constant) return a;
+                if(b == -constant) return defineGate(GateType::Or, {a, c});
+                if(c == -constant) return defineGate(GateType::Or, {a, b});
+            }
+            inputs = {a, b, c};
+            break;
+        }
+        case GateType::Merge:
+            if(inputs.size() == 2) {
+                vector<Int> kept;
+                for(Int input : inputs) if(input != 0) kept.push_back(input);
+                return defineGate(GateType::And, kept);
+            }
+            break;
+    }
 
-    util::printConstraint(variable,  coefficient, limit);
+    vector<Int> key(inputs);
+    key.insert(key.begin(), (Int)type);
+    auto found = gateTable.find(key);
+    if(found != gateTable.end()) return negated ? -found->second : found->second;
+    Int auxVar = getNewAuxVar();
+    addGate(type, auxVar, inputs);
+    gateTable[key] = auxVar;
+    return negated ? -auxVar : auxVar;
+}
 
-    maxCoefficient = coefficientBit = 0;
-    for(auto coef : coefficient) {
-        maxCoefficient = std::max(coef, maxCoefficient);
+Int Encoder::defineAnd(const vector<Int> &inputs) {   // aux <--> inputs[0] /\ inputs[1] /\ ...
+    return defineGate(GateType::And, inputs);
+}
+
+Int Encoder::defineOr(const vector<Int> &inputs) {    // aux <--> inputs[0] \/ inputs[1] \/ ...
+    return defineGate(GateType::Or, inputs);
+}
+
+// constraints some encoding handles better than the chosen encoder, whatever it is
+bool Encoder::encodeSpecialConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    if(directEncode(variable, coefficient, lowerLimit, limit)) return true;
+    if(variable.size() <= primeImplicateTerms && primeImplicateEncode(variable, coefficient, lowerLimit, limit)) return true;
+    bool unitCoefficients = std::all_of(coefficient.begin(), coefficient.end(), [](Int ai) { return ai == 1; });
+    if(atMostOne && unitCoefficients && limit == 1) {
+        if(DEBUG) util::printConstraint(variable, coefficient, limit, lowerLimit);
+        atMostOneEncode(variable, lowerLimit == 1);
+        return true;
+    }
+    if(cardinalityNetwork && unitCoefficients) {
+        if(DEBUG) util::printConstraint(variable, coefficient, limit, lowerLimit);
+        cardinalityEncode(variable, lowerLimit, limit);
+        return true;
     }
+    return false;
+}
 
-    while((maxCoefficient >> coefficientBit) > 0) {
-        coefficientBit++;
+// sum ax <= limit as units -x for every a > limit and, unless the rest can never exceed limit,
+// one clause over the rest; false if the rest is no clause, i.e. dropping its smallest term is not enough
+bool Encoder::directClauses(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit, vector<vector<Int> > &directClause) {
+    Int restSum = 0, restMin = DUMMY_MAX_INT;
+    vector<Int> restClause;
+    for(Int i = 0; i < variable.size(); i++) {
+        if(coefficient[i] > limit) {
+            directClause.push_back({-variable[i]});
+        } else {
+            restSum += coefficient[i];
+            restMin = std::min(restMin, coefficient[i]);
+            restClause.push_back(-variable[i]);
+        }
     }
+    if(restSum <= limit) return true;
+    if(restSum - restMin > limit) return false;
+    directClause.push_back(restClause);
+    return true;
+}
 
-    // cout << "maxCoefficient: " << maxCoefficient << "  coefficientBit: " << coefficientBit << std::endl;
+// constraints that are just clauses or units, both sides of a range alike, with no aux var
+bool Encoder::directEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    vector<vector<Int> > directClause;
+    if(!directClauses(variable, coefficient, limit, directClause)) return false;
+    if(lowerLimit > 0) {
+        vector<Int> inverseVariable(variable), inverseCoefficient(coefficient);
+        Int inverseLimit = lowerLimit;
+        util::inverseConstraint(inverseVariable, inverseCoefficient, inverseLimit);
+        if(!directClauses(inverseVariable, inverseCoefficient, inverseLimit, directClause)) return false;
+    }
 
-    vector<Int> auxVars = intervalEncode(variable, coefficient, left, right);
-    limitEncode(limit, auxVars);
+    if(DEBUG) util::printConstraint(variable, coefficient, limit, lowerLimit);
+    for(vector<Int> &clause : directClause) addClause(clause);
+    return true;
 }
 
-vector<Int> WarnersEncoder::intervalEncode(const vector<Int>& variable, const vector<Int> &coefficient, Int left, Int right) {
-    if(DEBUG) cout << std::endl << "In intervalEnode left-right : " << left << "-" << right << std::endl;
-    vector<Int> auxVars;
-    vector<Int> tmpClause;
-    if(left == right) { // leaf
-        // cout << "In intervalEnode left-right : " << left << "-" << right << std::endl;
-        Int xi = variable[left];
-        Int ai = coefficient[left];
-        auxVars.resize(coefficientBit);
-        // formula (10)
-        if(DEBUG) cout << "For ai = " << ai << "   xi = " << xi << std::endl;
-        for(Int i = 0; i < auxVars.size(); i++) {
-            auxVars[i] = getNewAuxVar();        // p_k^{left}
-            if(DEBUG) {
-                cout << "auxVars[" << i << "]  = " << auxVars[i] << std::endl;
-            }
-            if((ai >> i) & 1) {                 // i \in B_{a_i}
-                tmpClause.push_back(-auxVars[i]); tmpClause.push_back(xi);
-                addClause(tmpClause); tmpClause.clear();
+// Minimal covers (term sets whose sum exceeds limit, none of them dropable) of descending
+// coefficients, as positions. Their clauses -x_S are the prime implicates of the monotone
+// sum ax <= limit. false if there are more than PRIME_IMPLICATE_MAX_CLAUSES. Cached by shape.
+bool Encoder::minimalCovers(const vector<Int> &sortedCoefficient, const Int &limit, vector<vector<Int> > &cover) {
+    string shape = to_string(limit);
+    for(Int ai : sortedCoefficient) shape += "_" + to_string(ai);
+    if(largeShapes.find(shape) != largeShapes.end()) return false;
+    auto cached = implicateShapes.find(shape);
+    if(cached != implicateShapes.end()) {
+        cover = cached->second;
+        return true;
+    }
 
-                tmpClause.push_back(auxVars[i]); tmpClause.push_back(-xi);
-                addClause(tmpClause); tmpClause.clear();
-            } else {                            // i \notin B_{a_i}
-                tmpClause.push_back(-auxVars[i]);
+    Int n = sortedCoefficient.size();
+    vector<Int> suffixSum(n + 1, 0);
+    for(Int i = n - 1; i >= 0; i--) suffixSum[i] = suffixSum[i + 1] + sortedCoefficient[i];
+
+    // terms are tried largest first, so the sum exceeds limit first at the smallest term of a cover
+    vector<Int> chosen;
+    std::function<bool(Int, Int)> search = [&](Int i, Int sum) {
+        if(sum > limit) {
+            cover.push_back(chosen);
+            return cover.size() <= PRIME_IMPLICATE_MAX_CLAUSES;
+        }
+        if(sum + suffixSum[i] <= limit) return true;
+        chosen.push_back(i);
+        bool small = search(i + 1, sum + sortedCoefficient[i]);
+        chosen.pop_back();
+        return small && search(i + 1, sum);
+    };
+    if(!search(0, 0)) {
+        cover.clear();
+        largeShapes.insert(shape);
+        return false;
+    }
+    implicateShapes[shape] = cover;
+    return true;
+}
+
+bool Encoder::implicateClauses(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit, vector<vector<Int> > &implicateClause) {
+    vector<Int> order(variable.size());
+    for(Int i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](Int i, Int j) { return coefficient[i] > coefficient[j]; });
+    vector<Int> sortedCoefficient;
+    for(Int i : order) sortedCoefficient.push_back(coefficient[i]);
+
+    vector<vector<Int> > cover;
+    if(!minimalCovers(sortedCoefficient, limit, cover)) return false;
+    for(const vector<Int> &positions : cover) {
+        vector<Int> clause;
+        for(Int p : positions) clause.push_back(-variable[order[p]]);
+        implicateClause.push_back(clause);
+    }
+    return true;
+}
+
+// small constraints as the prime implicates of both sides, over their own variables only
+bool Encoder::primeImplicateEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    vector<vector<Int> > implicateClause;
+    if(!implicateClauses(variable, coefficient, limit, implicateClause)) return false;
+    if(lowerLimit > 0) {
+        vector<Int> inverseVariable(variable), inverseCoefficient(coefficient);
+        Int inverseLimit = lowerLimit;
+        util::inverseConstraint(inverseVariable, inverseCoefficient, inverseLimit);
+        if(!implicateClauses(inverseVariable, inverseCoefficient, inverseLimit, implicateClause)) return false;
+    }
+    if(implicateClause.size() > PRIME_IMPLICATE_MAX_CLAUSES) return false;
+
+    if(DEBUG) util::printConstraint(variable, coefficient, limit, lowerLimit);
+    for(vector<Int> &clause : implicateClause) addClause(clause);
+    return true;
+}
+
+// x1 + ... + xn <= 1 (= 1 if exactlyOne), pairwise for small n, otherwise a ladder of
+// prefix ors y_i <--> y_{i-1} \/ x_i with -y_{i-1} \/ -x_i
+void Encoder::atMostOneEncode(const vector<Int>& variable, bool exactlyOne) {
+    Int n = variable.size();
+    vector<Int> tmpClause;
+    if(n <= AT_MOST_ONE_PAIRWISE_SIZE) {
+        for(Int i = 0; i < n; i++) {
+            for(Int j = i + 1; j < n; j++) {
+                tmpClause.push_back(-variable[i]); tmpClause.push_back(-variable[j]);
                 addClause(tmpClause); tmpClause.clear();
             }
         }
-    } else {            // subtree root
-        Int mid = (left + right) >> 1;
-        vector<Int> auxVarsL = intervalEncode(variable, coefficient, left, mid);
-        vector<Int> auxVarsR = intervalEncode(variable, coefficient, mid + 1, right);
-        if(DEBUG) cout << "Back to intervalEnode left-right : " << left << "-" << right << std::endl;
-        if(auxVarsL.size() != auxVarsR.size()) {
-            if(DEBUG) cout << "* different size between " << auxVarsL.size() << " " << auxVarsR.size() << std::endl;
-            auxVarsR.push_back(getNewAuxVar());
-            if(DEBUG) cout << "auxVarsR add " << auxVarsR[auxVarsR.size()-1] << std::endl;
-            tmpClause.push_back(-auxVarsR[auxVarsR.size()-1]);
+    } else {
+        Int prefix = variable.front();
+        for(Int i = 1; i < n; i++) {
+            tmpClause.push_back(-prefix); tmpClause.push_back(-variable[i]);
             addClause(tmpClause); tmpClause.clear();
+            if(i + 1 < n) prefix = defineOr({prefix, variable[i]});
         }
-        auxVars.resize(auxVarsL.size() + 1);
-        vector<Int> carryVar(auxVarsL.size());
-        for(Int i = 0; i < auxVars.size(); i++) auxVars[i] = getNewAuxVar();
-        for(Int i = 0; i < carryVar.size(); i++) carryVar[i] = getNewAuxVar();
-        if(DEBUG) {
-            cout << "For auxVars: ";
-            for(Int i = 0; i < auxVars.size(); i++) cout << " " << auxVars[i];
-            cout << std::endl;
-            cout << "For carryVars: ";
-            for(Int i = 0; i < carryVar.size(); i++) cout << " " << carryVar[i];
-            cout << std::endl;
-        }
-        
-        // mathcal{T}^+ (subroot, lsubtree, rsubtree)
-        // formula (4)
-        if(DEBUG) cout << "formula 4" << std::endl;
-        tmpClause.push_back(-auxVars[0]); tmpClause.push_back(-auxVarsL[0]); tmpClause.push_back(-auxVarsR[0]);
-        addClause(tmpClause); tmpClause.clear();
+    }
+    if(exactlyOne) {
+        tmpClause = variable;
+        addClause(tmpClause);
+    }
+}
 
-        tmpClause.push_back(-auxVars[0]); tmpClause.push_back(auxVarsL[0]); tmpClause.push_back(auxVarsR[0]);
-        addClause(tmpClause); tmpClause.clear();
+// lowerLimit <= x1 + ... + xn <= limit, with the outputs of a sorting network cut at limit + 1
+void Encoder::cardinalityEncode(const vector<Int>& variable, const Int &lowerLimit, const Int &limit) {
+    Int n = variable.size();
+    Int outputCnt = std::max(limit < n ? limit + 1 : 0, lowerLimit);
+    if(outputCnt == 0) return;
 
-        tmpClause.push_back(auxVars[0]); tmpClause.push_back(auxVarsL[0]); tmpClause.push_back(-auxVarsR[0]);
+    vector<Int> output = sortEncode(variable, outputCnt);
+    vector<Int> tmpClause;
+    if(limit < n) {
+        tmpClause.push_back(-output[limit]);
         addClause(tmpClause); tmpClause.clear();
+    }
+    if(lowerLimit > 0) {
+        tmpClause.push_back(output[lowerLimit - 1]);
+        addClause(tmpClause);
+    }
+}
 
-        tmpClause.push_back(auxVars[0]); tmpClause.push_back(-auxVarsL[0]); tmpClause.push_back(auxVarsR[0]);
-        addClause(tmpClause); tmpClause.clear();
+// Batcher's odd-even merge sort on wireCnt wires (a power of two) whose blocks of
+// firstBlock wires are already sorted, so firstBlock = wireCnt / 2 is a single merge
+vector<Pair<Int, Int> > Encoder::oddEvenMergeNetwork(Int wireCnt, Int firstBlock) {
+    vector<Pair<Int, Int> > comparators;
+    for(Int p = firstBlock; p < wireCnt; p <<= 1) {
+        for(Int k = p; k >= 1; k >>= 1) {
+            for(Int j = k % p; j + k < wireCnt; j += 2 * k) {
+                for(Int i = 0; i < std::min(k, wireCnt - j - k); i++) {
+                    if((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        comparators.push_back({i + j, i + j + k});
+                    }
+                }
+            }
+        }
+    }
+    return comparators;
+}
 
-        // formula (5)
-        if(DEBUG) cout << "formula 5" << std::endl;
-        tmpClause.push_back(-carryVar[0]); tmpClause.push_back(auxVarsL[0]);
-        addClause(tmpClause); tmpClause.clear();
+// output[t] <--> at least t + 1 of the literals, and of the sortedLiteral sequences (each with
+// sequence[t] <--> at least t + 1 true, so already sorted), are true, for t < outputCnt <= their count.
+// A cardinality network: blocks are sorted and merged pairwise, each cut to its top outputCnt wires.
+// Wires are padded with constant false and the comparators run on symbolic signals first,
+// so comparators against false vanish and only gates some output depends on are encoded.
+vector<Int> Encoder::sortEncode(const vector<Int>& literal, Int outputCnt, const vector<vector<Int> > &sortedLiteral) {
+    Int n = literal.size();
+
+    // signal 0 is false, signals 1..n are the literals, then the sorted ones, the rest are and/or gates
+    enum class Gate {False, Input, And, Or};
+    vector<Int> inputLiteral(literal);
+    for(const vector<Int> &sequence : sortedLiteral) inputLiteral.insert(inputLiteral.end(), sequence.begin(), sequence.end());
+    Int inputCnt = inputLiteral.size();
+    vector<Gate> gate(inputCnt + 1, Gate::Input);
+    vector<Pair<Int, Int> > gateInputs(inputCnt + 1, {0, 0});
+    gate[0] = Gate::False;
+
+    auto runNetwork = [&](vector<Int> &wire, const vector<Pair<Int, Int> > &comparators) {
+        for(const Pair<Int, Int> &comparator : comparators) {
+            Int a = wire[comparator.first], b = wire[comparator.second];
+            if(a == 0 || b == 0) {
+                wire[comparator.first] = 0;
+                wire[comparator.second] = a + b;
+                continue;
+            }
+            gate.push_back(Gate::And); gateInputs.push_back({a, b});
+            wire[comparator.first] = gate.size() - 1;
+            gate.push_back(Gate::Or); gateInputs.push_back({a, b});
+            wire[comparator.second] = gate.size() - 1;
+        }
+    };
+    auto cutTop = [&](vector<Int> &wire) {
+        if(wire.size() > outputCnt) wire.erase(wire.begin(), wire.end() - outputCnt);
+    };
+
+    Int blockSize = 2;
+    while(blockSize < outputCnt) blockSize <<= 1;
+
+    vector<vector<Int> > sequences;
+    for(Int first = 0; first < n; first += blockSize) {
+        Int size = std::min(blockSize, n - first), wireCnt = 1;
+        auto network = SORTING_NETWORKS.lower_bound(size);
+        vector<Pair<Int, Int> > comparators;
+        if(network != SORTING_NETWORKS.end()) {
+            wireCnt = network->first;
+            comparators = network->second;
+        } else {
+            while(wireCnt < size) wireCnt <<= 1;
+            comparators = oddEvenMergeNetwork(wireCnt, 1);
+        }
+        vector<Int> wire(wireCnt, 0);   // false is already in place at the bottom
+        for(Int i = 0; i < size; i++) wire[wireCnt - size + i] = first + i + 1;
+        runNetwork(wire, comparators);
+        cutTop(wire);
+        sequences.push_back(wire);
+    }
+    Int signal = n + 1;
+    for(const vector<Int> &sequence : sortedLiteral) {
+        vector<Int> wire(sequence.size());
+        for(Int t = 0; t < sequence.size(); t++) wire[sequence.size() - 1 - t] = signal++;
+        cutTop(wire);
+        if(!wire.empty()) sequences.push_back(wire);
+    }
 
-        tmpClause.push_back(-carryVar[0]); tmpClause.push_back(auxVarsR[0]);
-        addClause(tmpClause); tmpClause.clear();
+    vector<Pair<Int, Int> > merger = oddEvenMergeNetwork(2 * blockSize, blockSize);
+    while(sequences.size() > 1) {
+        vector<vector<Int> > merged;
+        for(Int i = 0; i + 1 < sequences.size(); i += 2) {
+            vector<Int> wire(2 * blockSize, 0);
+            std::copy(sequences[i].begin(), sequences[i].end(), wire.begin() + blockSize - sequences[i].size());
+            std::copy(sequences[i + 1].begin(), sequences[i + 1].end(), wire.end() - sequences[i + 1].size());
+            runNetwork(wire, merger);
+            cutTop(wire);
+            merged.push_back(wire);
+        }
+        if(sequences.size() % 2 == 1) merged.push_back(sequences.back());
+        sequences.swap(merged);
+    }
+    const vector<Int> &wire = sequences.front();
 
-        tmpClause.push_back(carryVar[0]); tmpClause.push_back(-auxVarsL[0]); tmpClause.push_back(-auxVarsR[0]);
-        addClause(tmpClause); tmpClause.clear();
+    vector<bool> needed(gate.size(), false);
+    for(Int t = 0; t < outputCnt; t++) needed[wire[wire.size() - 1 - t]] = true;
+    for(Int g = gate.size() - 1; g > inputCnt; g--) {
+        if(!needed[g]) continue;
+        needed[gateInputs[g].first] = needed[gateInputs[g].second] = true;
+    }
 
-        // formula (6)
-        if(DEBUG) cout << "formula 6" << std::endl;
-        for(Int i = 1; i < auxVarsL.size(); i++) {      // [1, Mu - 1]
-            tmpClause.push_back(auxVars[i]); tmpClause.push_back(-auxVarsL[i]); 
-            tmpClause.push_back(-auxVarsR[i]); tmpClause.push_back(-carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+    vector<Int> signalLiteral(gate.size(), 0);
+    for(Int i = 0; i < inputCnt; i++) signalLiteral[i + 1] = inputLiteral[i];
+    for(Int g = inputCnt + 1; g < gate.size(); g++) {
+        if(!needed[g]) continue;
+        vector<Int> inputs = {signalLiteral[gateInputs[g].first], signalLiteral[gateInputs[g].second]};
+        signalLiteral[g] = gate[g] == Gate::And ? defineAnd(inputs) : defineOr(inputs);
+    }
 
-            tmpClause.push_back(auxVars[i]); tmpClause.push_back(-auxVarsL[i]); 
-            tmpClause.push_back(auxVarsR[i]); tmpClause.push_back(carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+    vector<Int> output(outputCnt);
+    for(Int t = 0; t < outputCnt; t++) output[t] = signalLiteral[wire[wire.size() - 1 - t]];
+    return output;
+}
 
-            tmpClause.push_back(auxVars[i]); tmpClause.push_back(auxVarsL[i]); 
-            tmpClause.push_back(-auxVarsR[i]); tmpClause.push_back(carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+// merges two totalizer nodes: with a_s, b_t sorted by value and o <--> child sum >= value,
+// P >= v <--> some A >= a_s /\ B >= b_t with min(a_s + b_t, saturation) >= v. Index 0 of
+// both children stands for the implicit (0, true); for each s only the smallest such t is kept,
+// and the pairs of one output form a single merge gate, so no pair gets a var of its own
+vector<Pair<Int, Int> > Encoder::nodeEncode(const vector<Pair<Int, Int> > &nodeA, const vector<Pair<Int, Int> > &nodeB, Int saturation) {
+    vector<Pair<Int, Int> > a = {{0, 0}}, b = {{0, 0}};
+    a.insert(a.end(), nodeA.begin(), nodeA.end());
+    b.insert(b.end(), nodeB.begin(), nodeB.end());
+
+    std::set<Int> values;
+    for(Int s = 0; s < a.size(); s++) {
+        for(Int t = 0; t < b.size(); t++) {
+            if(s + t > 0) values.insert(std::min(a[s].first + b[t].first, saturation));
+        }
+    }
+    vector<Pair<Int, Int> > node;
+    for(Int v : values) {
+        vector<Int> pairs;
+        Int t = b.size();
+        for(Int s = 0; s < a.size(); s++) {
+            Int smallest = t;
+            while(smallest > 0 && std::min(a[s].first + b[smallest - 1].first, saturation) >= v) smallest--;
+            if(smallest == t) continue;    // a larger a_s with the same b_t is subsumed
+            t = smallest;
+            pairs.push_back(a[s].second); pairs.push_back(b[t].second);
+        }
+        node.push_back({v, defineMerge(pairs)});
+    }
+    return node;
+}
 
-            tmpClause.push_back(auxVars[i]); tmpClause.push_back(auxVarsL[i]); 
-            tmpClause.push_back(auxVarsR[i]); tmpClause.push_back(-carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+Int Encoder::defineXor(Int a, Int b) {    // aux <--> a xor b
+    return defineGate(GateType::Xor, {a, b});
+}
 
-            tmpClause.push_back(-auxVars[i]); tmpClause.push_back(auxVarsL[i]); 
-            tmpClause.push_back(auxVarsR[i]); tmpClause.push_back(carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+Int Encoder::defineXor3(Int a, Int b, Int c) {   // aux <--> a xor b xor c
+    return defineGate(GateType::Xor3, {a, b, c});
+}
 
-            tmpClause.push_back(-auxVars[i]); tmpClause.push_back(auxVarsL[i]); 
-            tmpClause.push_back(-auxVarsR[i]); tmpClause.push_back(-carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+Int Encoder::defineMajority(Int a, Int b, Int c) {   // aux <--> at least two of a, b, c
+    return defineGate(GateType::Majority, {a, b, c});
+}
 
-            tmpClause.push_back(-auxVars[i]); tmpClause.push_back(-auxVarsL[i]); 
-            tmpClause.push_back(auxVarsR[i]); tmpClause.push_back(-carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+Int Encoder::defineIte(Int x, Int hi, Int lo) {   // aux <--> x ? hi : lo
+    return defineGate(GateType::Ite, {x, hi, lo});
+}
 
-            tmpClause.push_back(-auxVars[i]); tmpClause.push_back(-auxVarsL[i]); 
-            tmpClause.push_back(-auxVarsR[i]); tmpClause.push_back(carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+Int Encoder::defineOrAnd(Int a, Int b, Int c) {   // aux <--> a \/ (b /\ c)
+    return defineGate(GateType::OrAnd, {a, b, c});
+}
+
+Int Encoder::defineMerge(const vector<Int> &pairs) {   // aux <--> pairs[0] /\ pairs[1] \/ pairs[2] /\ pairs[3] \/ ...
+    return defineGate(GateType::Merge, pairs);
+}
+
+string Encoder::pair2Str(Int id, Int w) {
+    return to_string(id) + "_" + to_string(w); 
+}
+
+// builds D_{n, limit} <--> sum ax <= limit, reusing nodes already in str2AuxVar, and returns its literal.
+// The nodes reachable from the root are collected top-down, then defined bottom-up, each as the gate
+// D_{i, w} <--> x_i ? D_{i-1, w-a_i} : D_{i-1, w}, so equal nodes of any diagram share one var
+Int Encoder::diagramEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit, Map<string, Int> &str2AuxVar) {
+    Int consSize = variable.size();
+    vector<Int> preSum(consSize + 1);       // preSum[i] = Sum[a_1, a_i] <--> sum coefficient[0, i) i >= 1
+    std::queue<Pair<Int, Int> > unmarked;
+    vector<vector<Int> > levelWeights(consSize + 1);    // w of the new nodes D_{id, w}, by id
+    Set<string> reached;
+
+    preSum[0] = 0;
+    for(Int i = 0; i < consSize; i++) {
+        preSum[i + 1] = preSum.at(i) + coefficient.at(i);
+    }
+
+    unmarked.push({consSize, limit});
+    reached.insert(pair2Str(consSize, limit));
+    while(!unmarked.empty()) {
+        Int id = unmarked.front().first, w = unmarked.front().second; unmarked.pop();
+        if(str2AuxVar.find(pair2Str(id, w)) != str2AuxVar.end()) continue;
+        levelWeights[id].push_back(w);
+        if(w <= 0 || w >= preSum.at(id)) continue;         // terminal node
+        for(Int childW : {w - coefficient.at(id - 1), w}) {
+            if(reached.insert(pair2Str(id - 1, childW)).second) unmarked.push({id - 1, childW});
         }
+    }
 
-        // formula (7)
-        if(DEBUG) cout << "formula 7" << std::endl;
-        for(Int i = 1; i < auxVarsL.size(); i++) {
-            tmpClause.push_back(carryVar[i]); tmpClause.push_back(-auxVarsL[i]); tmpClause.push_back(-auxVarsR[i]);
-            addClause(tmpClause); tmpClause.clear();
+    vector<Int> noneSet;                    // not x_1, ..., not x_id
+    for(Int id = 0; id <= consSize; id++) {
+        if(id > 0) noneSet.push_back(-variable.at(id - 1));
+        for(Int w : levelWeights[id]) {
+            Int node;
+            if(w < 0) {
+                node = getFalseVar();
+            } else if(w >= preSum.at(id)) {
+                node = -getFalseVar();
+            } else if(w == 0) {
+                node = defineAnd(noneSet);
+            } else {
+                node = defineIte(variable.at(id - 1), str2AuxVar.at(pair2Str(id - 1, w - coefficient.at(id - 1))), str2AuxVar.at(pair2Str(id - 1, w)));
+            }
+            str2AuxVar[pair2Str(id, w)] = node;
+        }
+    }
+    return str2AuxVar.at(pair2Str(consSize, limit));
+}
 
-            tmpClause.push_back(carryVar[i]); tmpClause.push_back(-auxVarsL[i]); tmpClause.push_back(-carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+void WarnersEncoder::encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit) {
+    util::printConstraint(variable,  coefficient, limit);
 
-            tmpClause.push_back(carryVar[i]); tmpClause.push_back(-auxVarsR[i]); tmpClause.push_back(-carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+    Int sum = 0;
+    for(Int coef : coefficient) sum += coef;
+    setSaturation(sum, limit);
+    vector<Int> auxVars = termsEncode(variable, coefficient);
+    saturationBits = 0;
+    limitEncode(limit, auxVars);
+}
 
-            tmpClause.push_back(-carryVar[i]); tmpClause.push_back(auxVarsL[i]); tmpClause.push_back(auxVarsR[i]);
-            addClause(tmpClause); tmpClause.clear();
+void WarnersEncoder::encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    if(DEBUG) util::printConstraint(variable, coefficient, limit, lowerLimit);
 
-            tmpClause.push_back(-carryVar[i]); tmpClause.push_back(auxVarsL[i]); tmpClause.push_back(carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+    Int sum = 0;
+    for(Int coef : coefficient) sum += coef;
+    setSaturation(sum, comparedBound(sum, lowerLimit, limit));
+    vector<Int> auxVars = termsEncode(variable, coefficient);
+    saturationBits = 0;
+    if(limit < sum) limitEncode(limit, auxVars);
+    geqEncode(lowerLimit, auxVars);
+}
 
-            tmpClause.push_back(-carryVar[i]); tmpClause.push_back(auxVarsR[i]); tmpClause.push_back(carryVar[i-1]);
-            addClause(tmpClause); tmpClause.clear();
+void WarnersEncoder::encodeConstraints(const vector<vector<Int> > &variables, const vector<vector<Int> > &coefficients, const vector<Int> &lowerLimits, const vector<Int> &limits) {
+    if(!shareSubSums && !shareLhs) {
+        Encoder::encodeConstraints(variables, coefficients, lowerLimits, limits);
+        return;
+    }
+
+    vector<vector<Int> > lhsConstraints;        // constraints over the same LHS, first one is the representative
+    vector<bool> flipped(variables.size(), false);  // LHS is the representative's with every literal negated
+    vector<vector<Int> > repVariables, repCoefficients;
+    if(shareLhs) {
+        findSharedLhs(variables, coefficients, lhsConstraints, flipped);
+    } else {
+        for(Int i = 0; i < variables.size(); i++) lhsConstraints.push_back({i});
+    }
+    for(const vector<Int> &members : lhsConstraints) {
+        repVariables.push_back(variables.at(members.front()));
+        repCoefficients.push_back(coefficients.at(members.front()));
+    }
+
+    if(shareSubSums) findSharedSubSums(repVariables, repCoefficients);
+
+    for(Int g = 0; g < lhsConstraints.size(); g++) {
+        const vector<Int> &coefficient = repCoefficients.at(g);
+        vector<Int> variable(repVariables.at(g));
+        Int sum = 0, need = 0, complementNeed = 0;
+        for(Int coef : coefficient) sum += coef;
+        vector<Int> groupLowerLimits, groupLimits;  // members over the representative's LHS
+        for(Int i : lhsConstraints.at(g)) {         // sum a(-x) in [lower, limit]  <==>  sum ax in [sum - limit, sum - lower]
+            groupLowerLimits.push_back(flipped.at(i) ? std::max(sum - limits.at(i), (Int)0) : lowerLimits.at(i));
+            groupLimits.push_back(flipped.at(i) ? sum - lowerLimits.at(i) : limits.at(i));
+            need = std::max(need, comparedBound(sum, groupLowerLimits.back(), groupLimits.back()));
+            complementNeed = std::max(complementNeed, comparedBound(sum, std::max(sum - groupLimits.back(), (Int)0), sum - groupLowerLimits.back()));
         }
+        bool complemented = !shareSubSums && complementNeed < need;    // shared sub-sums are over the given literals
+        if(complemented) {
+            for(Int &x : variable) x = -x;
+            for(Int m = 0; m < groupLimits.size(); m++) {
+                Int complementLimit = sum - groupLowerLimits.at(m);
+                groupLowerLimits.at(m) = std::max(sum - groupLimits.at(m), (Int)0);
+                groupLimits.at(m) = complementLimit;
+            }
+        }
+        setSaturation(sum, complemented ? complementNeed : need);
+        vector<Int> auxVars = shareSubSums ? sharedTermsEncode(g, variable, coefficient) : termsEncode(variable, coefficient);
+        saturationBits = 0;
+
+        for(Int m = 0; m < groupLimits.size(); m++) {
+            Int i = lhsConstraints.at(g).at(m);
+            if(DEBUG) util::printConstraint(variables.at(i), coefficients.at(i), limits.at(i), lowerLimits.at(i));
+            if(groupLimits.at(m) < sum) limitEncode(groupLimits.at(m), auxVars);
+            geqEncode(groupLowerLimits.at(m), auxVars);
+        }
+    }
+}
 
-        // formula (8)
-        if(DEBUG) cout << "formula 8" << std::endl;
-        tmpClause.push_back(carryVar[carryVar.size()-1]); tmpClause.push_back(-auxVars[auxVars.size()-1]);
-        addClause(tmpClause); tmpClause.clear();
+// constraints whose LHS are equal up to term order, or up to negating every
+// literal (as "=" and ">=" produce), are grouped so they share one adder
+void WarnersEncoder::findSharedLhs(const vector<vector<Int> > &variables, const vector<vector<Int> > &coefficients, vector<vector<Int> > &lhsConstraints, vector<bool> &flipped) {
+    std::map<vector<Pair<Int, Int> >, Pair<Int, bool> > lhsGroup;     // canonical LHS -> (group, representative flipped)
+    vector<Pair<Int, Int> > lhs, flippedLhs;
 
-        tmpClause.push_back(-carryVar[carryVar.size()-1]); tmpClause.push_back(auxVars[auxVars.size()-1]);
-        addClause(tmpClause); tmpClause.clear();
+    lhsConstraints.clear();
+    for(Int i = 0; i < variables.size(); i++) {
+        lhs.clear(); flippedLhs.clear();
+        for(Int t = 0; t < variables.at(i).size(); t++) {
+            lhs.push_back({variables.at(i).at(t), coefficients.at(i).at(t)});
+            flippedLhs.push_back({-variables.at(i).at(t), coefficients.at(i).at(t)});
+        }
+        std::sort(lhs.begin(), lhs.end());
+        std::sort(flippedLhs.begin(), flippedLhs.end());
+
+        bool canonicalFlipped = flippedLhs < lhs;
+        auto found = lhsGroup.find(canonicalFlipped ? flippedLhs : lhs);
+        if(found == lhsGroup.end()) {
+            lhsGroup[canonicalFlipped ? flippedLhs : lhs] = {lhsConstraints.size(), canonicalFlipped};
+            lhsConstraints.push_back({i});
+        } else {
+            lhsConstraints.at(found->second.first).push_back(i);
+            flipped.at(i) = canonicalFlipped != found->second.second;
+        }
+    }
+
+    if(DEBUG) cout << "Found " << lhsConstraints.size() << " distinct LHS in " << variables.size() << " constraints" << std::endl;
+}
+
+vector<Int> WarnersEncoder::sharedTermsEncode(Int i, const vector<Int>& variable, const vector<Int> &coefficient) {
+    vector<Pair<Int, vector<Int> > > subtrees;      // (coefficient sum, output bits)
+    vector<Int> localVariable, localCoefficient;
+    Int sum = 0;
+    for(Int t : constraintTerms.at(i)) {
+        localVariable.push_back(variable.at(t));
+        localCoefficient.push_back(coefficient.at(t));
+        sum += coefficient.at(t);
     }
+    if(!localVariable.empty()) {
+        subtrees.push_back({sum, termsEncode(localVariable, localCoefficient)});
+    }
+
+    for(Int s : constraintShares.at(i)) {
+        if(sharedAuxVars.at(s).empty()) {           // first constraint using it encodes it, unsaturated
+            if(DEBUG) cout << "Encode shared sub-sum " << s << std::endl;
+            Int constraintSaturationBits = saturationBits;
+            saturationBits = 0;
+            sharedAuxVars.at(s) = termsEncode(sharedVariables.at(s), sharedCoefficients.at(s));
+            saturationBits = constraintSaturationBits;
+        }
+        sum = 0;
+        for(Int coef : sharedCoefficients.at(s)) sum += coef;
+        subtrees.push_back({sum, sharedAuxVars.at(s)});
+    }
+
+    return combineEncode(subtrees);
+}
+
+// terms (literal, coefficient) occurring in exactly the same set of constraints
+// always appear together, so each such group (of at least two terms, shared by
+// at least two constraints) is a sub-sum that only needs one adder subtree
+void WarnersEncoder::findSharedSubSums(const vector<vector<Int> > &variables, const vector<vector<Int> > &coefficients) {
+    std::map<Pair<Int, Int>, vector<Int> > termConstraints;     // term -> constraints containing it
+    std::set<Pair<Int, Int> > repeatedTerms;
+
+    for(Int i = 0; i < variables.size(); i++) {
+        for(Int t = 0; t < variables.at(i).size(); t++) {
+            Pair<Int, Int> term = {variables.at(i).at(t), coefficients.at(i).at(t)};
+            vector<Int> &occurrence = termConstraints[term];
+            if(!occurrence.empty() && occurrence.back() == i) {
+                repeatedTerms.insert(term);                     // appears twice in one constraint
+            } else {
+                occurrence.push_back(i);
+            }
+        }
+    }
+
+    std::map<vector<Int>, vector<Pair<Int, Int> > > signatureTerms;
+    for(const auto &kv : termConstraints) {
+        if(kv.second.size() < 2 || repeatedTerms.count(kv.first)) continue;
+        signatureTerms[kv.second].push_back(kv.first);
+    }
+
+    sharedVariables.clear(); sharedCoefficients.clear(); sharedAuxVars.clear();
+    constraintShares.assign(variables.size(), vector<Int>());
+    constraintTerms.assign(variables.size(), vector<Int>());
+
+    std::map<Pair<Int, Int>, Int> termShare;
+    for(const auto &kv : signatureTerms) {
+        if(kv.second.size() < 2) continue;
+        Int s = sharedVariables.size();
+        sharedVariables.push_back(vector<Int>());
+        sharedCoefficients.push_back(vector<Int>());
+        sharedAuxVars.push_back(vector<Int>());
+        for(const Pair<Int, Int> &term : kv.second) {
+            sharedVariables[s].push_back(term.first);
+            sharedCoefficients[s].push_back(term.second);
+            termShare[term] = s;
+        }
+        for(Int i : kv.first) constraintShares[i].push_back(s);
+    }
+
+    for(Int i = 0; i < variables.size(); i++) {
+        for(Int t = 0; t < variables.at(i).size(); t++) {
+            if(termShare.find({variables.at(i).at(t), coefficients.at(i).at(t)}) == termShare.end()) {
+                constraintTerms[i].push_back(t);
+            }
+        }
+    }
+
+    if(DEBUG) cout << "Found " << sharedVariables.size() << " shared sub-sums" << std::endl;
+}
+
+vector<Int> WarnersEncoder::termsEncode(const vector<Int>& variable, const vector<Int> &coefficient) {
+    vector<Int> groupedVariable, groupedCoefficient;
+    if(groupCoefficients && groupEncode(variable, coefficient, groupedVariable, groupedCoefficient)) {
+        return termsEncode(groupedVariable, groupedCoefficient);
+    }
+    if(treeStrategy == WarnersTreeStrategy::CarrySave) return carrySaveEncode(variable, coefficient);
+
+    // a bin of bit-disjoint terms needs no adder: its row of literals already is the sum
+    vector<vector<Int> > bins = disjointBins(coefficient);
+    if(bins.size() == variable.size()) return treeEncode(variable, coefficient);
+
+    vector<Pair<Int, vector<Int> > > subtrees;      // (coefficient sum, output bits)
+    vector<Int> restVariable, restCoefficient;
+    Int restSum = 0;
+    for(const vector<Int> &bin : bins) {
+        if(bin.size() == 1) {
+            restVariable.push_back(variable[bin[0]]);
+            restCoefficient.push_back(coefficient[bin[0]]);
+            restSum += coefficient[bin[0]];
+            continue;
+        }
+        Int binSum = 0;
+        for(Int i : bin) binSum += coefficient[i];
+        if(DEBUG) cout << "Bit-disjoint row of " << bin.size() << " terms with sum " << binSum << std::endl;
+        subtrees.push_back({binSum, rowBits(disjointRow(variable, coefficient, bin))});
+    }
+    if(!restVariable.empty()) subtrees.push_back({restSum, treeEncode(restVariable, restCoefficient)});
+    return combineEncode(subtrees);
+}
+
+vector<Int> WarnersEncoder::treeEncode(const vector<Int>& variable, const vector<Int> &coefficient) {
+    maxCoefficient = coefficientBit = 0;
+    for(auto coef : coefficient) {
+        maxCoefficient = std::max(coef, maxCoefficient);
+    }
+
+    while((maxCoefficient >> coefficientBit) > 0) {
+        coefficientBit++;
+    }
+
+    // cout << "maxCoefficient: " << maxCoefficient << "  coefficientBit: " << coefficientBit << std::endl;
+
+    switch(treeStrategy) {
+        case WarnersTreeStrategy::Balanced: return levelEncode(variable, coefficient);
+        case WarnersTreeStrategy::Huffman:  return huffmanEncode(variable, coefficient);
+        case WarnersTreeStrategy::CarrySave: return carrySaveEncode(variable, coefficient);
+    }
+    return vector<Int>();
+}
+
+// Terms, largest coefficient first, go to the first bin none of whose coefficients shares a set bit
+// with theirs, so a bin adds up with no carry. Bins a coefficient did not fit stay unfit, as masks only grow
+vector<vector<Int> > WarnersEncoder::disjointBins(const vector<Int> &coefficient) {
+    vector<Int> order(coefficient.size()), mask;
+    for(Int i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](Int i, Int j) { return coefficient[i] > coefficient[j]; });
+
+    vector<vector<Int> > bins;
+    Map<Int, Int> firstFit;         // coefficient -> first bin it may still fit
+    for(Int i : order) {
+        Int b = firstFit[coefficient[i]];
+        while(b < bins.size() && (mask[b] & coefficient[i]) != 0) b++;
+        firstFit[coefficient[i]] = b;
+        if(b == bins.size()) {
+            bins.push_back({});
+            mask.push_back(0);
+        }
+        bins[b].push_back(i);
+        mask[b] |= coefficient[i];
+    }
+    return bins;
+}
+
+// bit k of a bin's sum is the term owning bit k, or 0 for false
+vector<Int> WarnersEncoder::disjointRow(const vector<Int>& variable, const vector<Int> &coefficient, const vector<Int> &bin) {
+    vector<Int> row;
+    for(Int i : bin) {
+        for(Int k = 0; (coefficient[i] >> k) > 0; k++) {
+            if(((coefficient[i] >> k) & 1) == 0) continue;
+            if(row.size() <= k) row.resize(k + 1, 0);
+            row[k] = variable[i];
+        }
+    }
+    return row;
+}
+
+// Only whether the sum exceeds need matters, so when need has noticeably fewer bits than sum,
+// partial sums keep just enough bits for need plus a sticky flag, defined as partial sum >= 2^bits.
+// A plain number one bit wider reads the same way, and so do limitEncode and geqEncode
+void WarnersEncoder::setSaturation(Int sum, Int need) {
+    Int needBit = 0, sumBit = 0;
+    while((need >> needBit) > 0) needBit++;
+    while((sum >> sumBit) > 0) sumBit++;
+    saturationBits = saturate && needBit + 1 < sumBit ? std::max(needBit, (Int)1) : 0;
+}
+
+// Terms sharing a coefficient c, at least COEFFICIENT_GROUP_MIN_SIZE of them, are counted in
+// binary by a carry-save counter, and each count bit b_t becomes the single term c * 2^t b_t.
+// false if there is no such group. Grouping again terminates, since every group shrinks the terms
+bool WarnersEncoder::groupEncode(const vector<Int>& variable, const vector<Int> &coefficient, vector<Int> &groupedVariable, vector<Int> &groupedCoefficient) {
+    std::map<Int, vector<Int> > group;
+    for(Int i = 0; i < variable.size(); i++) group[coefficient[i]].push_back(variable[i]);
+    bool grouped = false;
+    for(const auto &coefGroup : group) grouped |= coefGroup.second.size() >= COEFFICIENT_GROUP_MIN_SIZE;
+    if(!grouped) return false;
+
+    Set<Int> counted;
+    for(Int i = 0; i < variable.size(); i++) {
+        vector<Int> &members = group[coefficient[i]];
+        if(members.size() < COEFFICIENT_GROUP_MIN_SIZE) {
+            groupedVariable.push_back(variable[i]);
+            groupedCoefficient.push_back(coefficient[i]);
+        } else if(counted.insert(coefficient[i]).second) {   // the group's first term stands for all of it
+            if(DEBUG) cout << "Group of " << members.size() << " terms with coefficient " << coefficient[i] << std::endl;
+            vector<Int> countBits = carrySaveEncode(members, vector<Int>(members.size(), 1));
+            for(Int t = 0; t < countBits.size(); t++) {
+                groupedVariable.push_back(countBits[t]);
+                groupedCoefficient.push_back(coefficient[i] << t);
+            }
+        }
+    }
+    return true;
+}
+
+// Balanced tree built bottom-up: adjacent subtrees of a level are paired and
+// an odd one out moves up unchanged. The layout (children of every node) is fixed
+// before any gate is built, the nodes of a level are adjacent, and the nodes are then
+// built by one flat loop in index order instead of a recursion of depth log n. Leaves
+// and adders are hashed gates (the plain ones when saturationBits is 0), so a node
+// gets its vars from the gate table rather than owning a fixed block of them
+vector<Int> WarnersEncoder::levelEncode(const vector<Int>& variable, const vector<Int> &coefficient) {
+    Int leafCnt = variable.size();
+    vector<Int> childL(leafCnt, -1), childR(leafCnt, -1);
+    vector<Int> level(leafCnt), nextLevel;
+
+    for(Int i = 0; i < leafCnt; i++) level[i] = i;
+    while(level.size() > 1) {
+        nextLevel.clear();
+        for(Int j = 0; j + 1 < level.size(); j += 2) {
+            childL.push_back(level[j]); childR.push_back(level[j + 1]);
+            nextLevel.push_back(childL.size() - 1);
+        }
+        if(level.size() & 1) nextLevel.push_back(level.back());
+        level.swap(nextLevel);
+    }
+
+    vector<vector<Int> > nodeBits(childL.size());
+    for(Int v = 0; v < leafCnt; v++) {
+        nodeBits[v] = saturatedLeafEncode(variable[v], coefficient[v], coefficientBit);
+    }
+    for(Int v = leafCnt; v < nodeBits.size(); v++) {
+        nodeBits[v] = saturatedAdderEncode(nodeBits[childL[v]], nodeBits[childR[v]]);
+    }
+    return nodeBits[level.front()];
+}
+
+// Huffman-shaped tree: leaves are only as wide as their own coefficient and the two
+// subtrees with the smallest coefficient sums are always added first, so wide
+// coefficients join the tree as late (and as close to the root) as possible
+vector<Int> WarnersEncoder::huffmanEncode(const vector<Int>& variable, const vector<Int> &coefficient) {
+    vector<Pair<Int, vector<Int> > > subtrees;      // (coefficient sum, output bits)
+
+    for(Int i = 0; i < variable.size(); i++) {
+        Int ai = coefficient[i], bitWidth = 0;
+        while((ai >> bitWidth) > 0) bitWidth++;
+        subtrees.push_back({ai, saturatedLeafEncode(variable[i], ai, bitWidth)});
+    }
+    return combineEncode(subtrees);
+}
+
+// Carry-save tree: rows of bits (0 for a bit known to be false, so a row of bit-disjoint terms
+// is just each x_i at the 1 bits of its a_i) are reduced three to two by one full adder per
+// column, whose sum and carry go to two new rows. Only the last two rows are added with a ripple carry.
+// Saturated, every bit at or above column saturationBits goes straight into the flag instead
+vector<Int> WarnersEncoder::carrySaveEncode(const vector<Int>& variable, const vector<Int> &coefficient) {
+    std::deque<vector<Int> > rows;
+    std::set<Int> highBits;
+    auto cutRow = [&](vector<Int> &row) {
+        if(saturationBits == 0 || row.size() <= saturationBits) return;
+        for(Int j = saturationBits; j < row.size(); j++) if(row[j] != 0) highBits.insert(row[j]);
+        row.resize(saturationBits);
+    };
+    for(const vector<Int> &bin : disjointBins(coefficient)) {
+        vector<Int> row = disjointRow(variable, coefficient, bin);
+        cutRow(row);
+        rows.push_back(row);
+    }
+
+    while(rows.size() > 2) {
+        vector<Int> a = rows[0], b = rows[1], c = rows[2];
+        rows.erase(rows.begin(), rows.begin() + 3);
+        Int width = std::max({a.size(), b.size(), c.size()});
+        a.resize(width, 0); b.resize(width, 0); c.resize(width, 0);
+
+        vector<Int> sum(width, 0), carry(width + 1, 0);
+        for(Int j = 0; j < width; j++) {
+            vector<Int> inputs;
+            for(Int bit : {a[j], b[j], c[j]}) if(bit != 0) inputs.push_back(bit);
+            if(inputs.size() == 1) {
+                sum[j] = inputs[0];
+            } else if(inputs.size() == 2) {
+                sum[j] = defineXor(inputs[0], inputs[1]);
+                carry[j + 1] = defineAnd(inputs);
+            } else if(inputs.size() == 3) {
+                sum[j] = defineXor3(inputs[0], inputs[1], inputs[2]);
+                carry[j + 1] = defineMajority(inputs[0], inputs[1], inputs[2]);
+            }
+        }
+        cutRow(sum); cutRow(carry);
+        while(!sum.empty() && sum.back() == 0) sum.pop_back();
+        while(!carry.empty() && carry.back() == 0) carry.pop_back();
+        rows.push_back(sum);
+        rows.push_back(carry);
+    }
+
+    vector<Int> sum;
+    if(rows.size() == 1) sum = rows[0];
+
+    // the final ripple, only over the columns where both rows and the carry can be set
+    vector<Int> &l = rows[0], &r = rows.back();
+    Int carry = 0;
+    for(Int j = 0; rows.size() == 2 && (j < std::max(l.size(), r.size()) || carry != 0); j++) {
+        vector<Int> inputs;
+        for(Int bit : {j < l.size() ? l[j] : 0, j < r.size() ? r[j] : 0, carry}) if(bit != 0) inputs.push_back(bit);
+        carry = 0;
+        if(inputs.size() == 1) {
+            sum.push_back(inputs[0]);
+        } else if(inputs.size() == 2) {
+            sum.push_back(defineXor(inputs[0], inputs[1]));
+            carry = defineAnd(inputs);
+        } else if(inputs.size() == 3) {
+            sum.push_back(defineXor3(inputs[0], inputs[1], inputs[2]));
+            carry = defineMajority(inputs[0], inputs[1], inputs[2]);
+        } else {
+            sum.push_back(0);
+        }
+    }
+    cutRow(sum);
+    if(highBits.empty()) return rowBits(sum);
+    sum.resize(saturationBits, 0);
+    vector<Int> auxVars = rowBits(sum);
+    auxVars.push_back(defineOr(vector<Int>(highBits.begin(), highBits.end())));
+    return auxVars;
+}
+
+vector<Int> WarnersEncoder::rowBits(const vector<Int> &row) {    // false bits become the forced-false var
+    vector<Int> bits(row);
+    for(Int &bit : bits) {
+        if(bit == 0) bit = getFalseVar();
+    }
+    return bits;
+}
+
+vector<Int> WarnersEncoder::combineEncode(vector<Pair<Int, vector<Int> > > &subtrees) {
+    std::priority_queue<Pair<Int, Int>, vector<Pair<Int, Int> >, std::greater<Pair<Int, Int> > > bySum;  // (sum, subtree)
+
+    for(Int i = 0; i < subtrees.size(); i++) {
+        bySum.push({subtrees[i].first, i});
+    }
+
+    while(bySum.size() > 1) {
+        Pair<Int, Int> l = bySum.top(); bySum.pop();
+        Pair<Int, Int> r = bySum.top(); bySum.pop();
+        if(DEBUG) cout << "Combine sums " << l.first << " + " << r.first << std::endl;
+        vector<Int> auxVars = saturatedAdderEncode(subtrees[l.second].second, subtrees[r.second].second);
+        subtrees.push_back({l.first + r.first, auxVars});
+        bySum.push({l.first + r.first, subtrees.size() - 1});
+    }
+    return subtrees[bySum.top().second].second;
+}
+
+// p_k^{left} is x_i itself or false, so adders over the same leaves are the same gates
+vector<Int> WarnersEncoder::leafEncode(Int xi, Int ai, Int bitWidth) {
+    vector<Int> auxVars(bitWidth);
+    for(Int i = 0; i < auxVars.size(); i++) {
+        auxVars[i] = (ai >> i) & 1 ? xi : getFalseVar();
+    }
+    return auxVars;
+}
+
+// a leaf wider than the saturation keeps its low bits, and x_i itself is the flag
+vector<Int> WarnersEncoder::saturatedLeafEncode(Int xi, Int ai, Int bitWidth) {
+    if(saturationBits == 0 || bitWidth <= saturationBits) return leafEncode(xi, ai, bitWidth);
+    vector<Int> auxVars = leafEncode(xi, ai, saturationBits);
+    if((ai >> saturationBits) > 0) auxVars.push_back(xi);
+    return auxVars;
+}
+
+// formulas (4)-(7) bit by bit as hashed and folded gates, and (8) as the last carry itself
+vector<Int> WarnersEncoder::adderEncode(vector<Int> &auxVarsL, vector<Int> &auxVarsR) {
+    while(auxVarsL.size() != auxVarsR.size()) {
+        vector<Int> &auxVarsS = auxVarsL.size() < auxVarsR.size() ? auxVarsL : auxVarsR;
+        if(DEBUG) cout << "* different size between " << auxVarsL.size() << " " << auxVarsR.size() << std::endl;
+        auxVarsS.push_back(getFalseVar());
+    }
+    vector<Int> auxVars(auxVarsL.size() + 1);
+    auxVars[0] = defineXor(auxVarsL[0], auxVarsR[0]);
+    Int carry = defineAnd({auxVarsL[0], auxVarsR[0]});
+    for(Int i = 1; i < auxVarsL.size(); i++) {
+        auxVars[i] = defineXor3(auxVarsL[i], auxVarsR[i], carry);
+        carry = defineMajority(auxVarsL[i], auxVarsR[i], carry);
+    }
+    auxVars.back() = carry;
+    return auxVars;
+}
+
+// low bits added as usual, the carry out of them and both operand flags or-ed into the flag
+vector<Int> WarnersEncoder::saturatedAdderEncode(vector<Int> auxVarsL, vector<Int> auxVarsR) {
+    auxVarsL = saturateBits(auxVarsL);
+    auxVarsR = saturateBits(auxVarsR);
+    if(saturationBits == 0 || std::max(auxVarsL.size(), auxVarsR.size()) <= saturationBits) {
+        return adderEncode(auxVarsL, auxVarsR);
+    }
+
+    vector<Int> flags;
+    for(vector<Int> *auxVarsS : {&auxVarsL, &auxVarsR}) {
+        if(auxVarsS->size() <= saturationBits) continue;
+        flags.push_back(auxVarsS->back());
+        auxVarsS->pop_back();
+    }
+    vector<Int> auxVars = adderEncode(auxVarsL, auxVarsR);
+    if(auxVars.size() > saturationBits) {
+        flags.push_back(auxVars.back());
+        auxVars.pop_back();
+    }
+    auxVars.push_back(defineOr(flags));
+    return auxVars;
+}
+
+// a plain sum wider than saturationBits + 1 bits: or its high bits into the flag
+vector<Int> WarnersEncoder::saturateBits(const vector<Int> &bits) {
+    if(saturationBits == 0 || bits.size() <= saturationBits + 1) return bits;
+    vector<Int> auxVars(bits.begin(), bits.begin() + saturationBits);
+    auxVars.push_back(defineOr(vector<Int>(bits.begin() + saturationBits, bits.end())));
     return auxVars;
 }
 
 void WarnersEncoder::limitEncode(Int limit, vector<Int> &auxVars) {
     vector<Int> tmpClause;
+    if((limit >> auxVars.size()) > 0) return;       // every sum of auxVars.size() bits is <= limit
+    if(comparator == WarnersComparator::Offset) {   // sum + 2^w - 1 - limit must not overflow w bits
+        Int overflow = overflowEncode(((Int)1 << auxVars.size()) - 1 - limit, auxVars);
+        if(overflow != 0) {
+            tmpClause.push_back(-overflow);
+            addClause(tmpClause);
+        }
+        return;
+    }
     for(Int i = 0; i < auxVars.size(); i++) {
         if((limit >> i) & 1) continue;
         tmpClause.push_back(-auxVars[i]);
@@ -291,93 +1470,355 @@ void WarnersEncoder::limitEncode(Int limit, vector<Int> &auxVars) {
     }
 }
 
-string GenArcEncoder::pair2Str(Int id, Int w) {
-    return to_string(id) + "_" + to_string(w); 
+// carry out of auxVars + constant: only the carry chain of a constant adder, where a 1 bit of the
+// constant makes an or and a 0 bit an and, folded while the carry is still false. 0 if always false
+Int WarnersEncoder::overflowEncode(Int constant, const vector<Int> &auxVars) {
+    Int carry = 0;
+    for(Int j = 0; j < auxVars.size(); j++) {
+        if((constant >> j) & 1) {
+            carry = carry == 0 ? auxVars[j] : defineOr({auxVars[j], carry});
+        } else if(carry != 0) {
+            carry = defineAnd({auxVars[j], carry});
+        }
+    }
+    return carry;
 }
 
-Int GenArcEncoder::getPair2AuxVar(Map<string, Int> &str2AuxVar, Int id, Int w) {
-    string str = pair2Str(id, w);
-    if(str2AuxVar.find(str) == str2AuxVar.end()) {
-        str2AuxVar[str] = getNewAuxVar();
+// dual of limitEncode: for every 1 bit of the bound, that bit or a higher 0 bit of the bound is set
+void WarnersEncoder::geqEncode(Int bound, vector<Int> &auxVars) {
+    vector<Int> tmpClause;
+    if(bound <= 0) return;
+    if((bound >> auxVars.size()) > 0) {             // no sum of auxVars.size() bits reaches bound
+        addClause(tmpClause);
+        return;
+    }
+    if(comparator == WarnersComparator::Offset) {   // sum + 2^w - bound must overflow w bits
+        tmpClause.push_back(overflowEncode(((Int)1 << auxVars.size()) - bound, auxVars));
+        addClause(tmpClause);
+        return;
+    }
+    for(Int i = 0; i < auxVars.size(); i++) {
+        if(!((bound >> i) & 1)) continue;
+        tmpClause.push_back(auxVars[i]);
+        for(Int j = i + 1; j < auxVars.size(); j++) {
+            if(!((bound >> j) & 1)) {
+                tmpClause.push_back(auxVars[j]);
+            }
+        }
+        addClause(tmpClause); tmpClause.clear();
     }
-    return str2AuxVar.at(str);
 }
 
 void GenArcEncoder::encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit) {
-    Int consSize = variable.size();
     Map<string, Int> str2AuxVar;
-    vector<Int> preSum(consSize + 1);       // preSum[i] = Sum[a_1, a_i] <--> sum coefficient[0, i) i >= 1
-    std::queue<Pair<Int, Int> > unmarked;
     vector<Int> tmpClause;
 
     if(DEBUG) util::printConstraint(variable, coefficient, limit);
 
-    preSum[0] = 0;
-    for(Int i = 0; i < consSize; i++) {
-        preSum[i + 1] = preSum.at(i) + coefficient.at(i);
+    tmpClause.push_back(diagramEncode(variable, coefficient, limit, str2AuxVar));
+    addClause(tmpClause);
+}
+
+// both bounds are roots of one diagram: D_{n, limit} and not D_{n, lowerLimit - 1}
+void GenArcEncoder::encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    Map<string, Int> str2AuxVar;
+    vector<Int> tmpClause;
+
+    Int sum = 0;
+    for(Int coef : coefficient) sum += coef;
+
+    if(DEBUG) util::printConstraint(variable, coefficient, limit, lowerLimit);
+
+    if(limit < sum) {       // else D_{n, limit} is a forced true root
+        tmpClause.push_back(diagramEncode(variable, coefficient, limit, str2AuxVar));
+        addClause(tmpClause);
     }
 
-    // str2AuxVar[pair2Str(consSize, limit)] = getNewAuxVar();
     tmpClause.clear();
-    tmpClause.push_back(getPair2AuxVar(str2AuxVar, consSize, limit));
+    tmpClause.push_back(-diagramEncode(variable, coefficient, lowerLimit - 1, str2AuxVar));
     addClause(tmpClause);
+}
 
-    unmarked.push({consSize, limit});
+// long constraints are cut into blocks of similar coefficients. A block's partial
+// sum comes from a Warners subtree, or from a GenArc diagram turned into binary
+// when its coefficient sum is small enough for that to be cheaper, and the
+// partial sums are then added like any other Warners subtrees
+vector<Int> HybridEncoder::termsEncode(const vector<Int>& variable, const vector<Int> &coefficient) {
+    if(variable.size() <= hybridThreshold) {
+        return WarnersEncoder::termsEncode(variable, coefficient);
+    }
 
-    while(!unmarked.empty()) {
-        Int id = unmarked.front().first, w = unmarked.front().second; unmarked.pop(); 
+    vector<Int> order(variable.size());
+    for(Int i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](Int i, Int j) { return coefficient[i] < coefficient[j]; });
+
+    vector<Pair<Int, vector<Int> > > subtrees;      // (coefficient sum, output bits)
+    vector<Int> blockVariable, blockCoefficient;
+    for(Int first = 0; first < order.size(); first += HYBRID_BLOCK_SIZE) {
+        blockVariable.clear(); blockCoefficient.clear();
+        Int blockSum = 0, blockBit = 0, blockDepth = 0;
+        for(Int k = first; k < order.size() && k < first + HYBRID_BLOCK_SIZE; k++) {
+            blockVariable.push_back(variable[order[k]]);
+            blockCoefficient.push_back(coefficient[order[k]]);
+            blockSum += coefficient[order[k]];
+        }
+        Int blockSize = blockVariable.size();
+        while((blockCoefficient.back() >> blockBit) > 0) blockBit++;
+        while(((Int)1 << blockDepth) < blockSize) blockDepth++;
+
+        // clause estimates: 4 per diagram node vs. leaves plus (n - 1) adders of formulas (4)-(8)
+        Int diagramCost = 4 * blockSize * (blockSum + 1);
+        Int adderCost = 2 * blockSize * blockBit + 14 * (blockSize - 1) * (blockBit + blockDepth);
+        if(DEBUG) cout << "Hybrid block " << first / HYBRID_BLOCK_SIZE << " sum " << blockSum << (diagramCost < adderCost ? " -> GenArc" : " -> Warners") << std::endl;
+
+        if(diagramCost < adderCost) {
+            subtrees.push_back({blockSum, unaryBlockEncode(blockVariable, blockCoefficient)});
+        } else {
+            subtrees.push_back({blockSum, WarnersEncoder::termsEncode(blockVariable, blockCoefficient)});
+        }
+    }
+    return combineEncode(subtrees);
+}
 
-        if(w == 0) {
-            for(Int i = 0; i < id; i++) {
-                tmpClause.clear();
-                tmpClause.push_back(-variable.at(i)); tmpClause.push_back(-getPair2AuxVar(str2AuxVar, id, w));
-                addClause(tmpClause);
+// the block sum in binary from one GenArc diagram: atMost[w] <--> sum <= w for every
+// w < sum, and bit i is set iff the sum lies in one of the runs of values having bit i
+vector<Int> HybridEncoder::unaryBlockEncode(const vector<Int>& variable, const vector<Int> &coefficient) {
+    Map<string, Int> str2AuxVar;
+    Int blockSum = 0, bitWidth = 0;
+    for(Int coef : coefficient) blockSum += coef;
+    while((blockSum >> bitWidth) > 0) bitWidth++;
+
+    vector<Int> atMost(blockSum);
+    for(Int w = 0; w < blockSum; w++) {
+        atMost[w] = diagramEncode(variable, coefficient, w, str2AuxVar);
+    }
+
+    vector<Int> auxVars(bitWidth);
+    vector<Int> runs, inRun;
+    for(Int i = 0; i < bitWidth; i++) {
+        Int runLength = (Int)1 << i;
+        runs.clear();
+        for(Int a = runLength; a <= blockSum; a += 2 * runLength) {    // run [a, a + 2^i - 1]
+            Int b = a + runLength - 1;
+            inRun.clear();
+            inRun.push_back(-atMost[a - 1]);                            // sum >= a
+            if(b < blockSum) inRun.push_back(atMost[b]);                // sum <= b
+            runs.push_back(defineAnd(inRun));
+        }
+        auxVars[i] = defineOr(runs);
+    }
+    return auxVars;
+}
+
+void SWCEncoder::encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit) {
+    if(DEBUG) util::printConstraint(variable, coefficient, limit);
+    counterEncode(variable, coefficient, 0, limit);
+}
+
+void SWCEncoder::encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    if(DEBUG) util::printConstraint(variable, coefficient, limit, lowerLimit);
+    counterEncode(variable, coefficient, lowerLimit, limit);
+}
+
+// sequential weight counter: after term i, register j holds s_{i,j} <--> a_1x_1 + ... + a_ix_i >= j
+// for 1 <= j <= limit, defined in both directions by s_{i,j} <--> s_{i-1,j} \/ (x_i /\ s_{i-1,j-a_i}).
+// A register row is a vector of literals where 0 stands for false, so registers that are
+// constant or copies of an earlier literal get no aux var
+void SWCEncoder::counterEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    Int consSize = variable.size(), sum = 0;
+    for(Int coef : coefficient) sum += coef;
+    if(limit >= sum && lowerLimit <= 0) return;
+    Int width = comparedBound(sum, lowerLimit, limit);          // >= lowerLimit
+    vector<Int> row(width + 1, 0), nextRow(width + 1);        // row[0] unused
+    vector<Int> tmpClause;
+
+    for(Int i = 0; i < consSize; i++) {
+        Int xi = variable.at(i), ai = coefficient.at(i);
+
+        // overflow: x_i /\ s_{i-1,limit+1-a_i} would push the sum past limit
+        if(limit < sum) {
+            if(limit + 1 - ai <= 0) {
+                tmpClause.push_back(-xi);
+                addClause(tmpClause); tmpClause.clear();
+            } else if(row[limit + 1 - ai] != 0) {
+                tmpClause.push_back(-xi); tmpClause.push_back(-row[limit + 1 - ai]);
+                addClause(tmpClause); tmpClause.clear();
             }
+        }
+
+        if(i == consSize - 1 && lowerLimit <= 0) break;       // last row is only needed for lowerLimit
+        for(Int j = 1; j <= width; j++) {
+            nextRow[j] = registerEncode(row[j], xi, j - ai <= 0 ? xi : row[j - ai]);
+        }
+        row.swap(nextRow);
+    }
 
-            tmpClause.clear();
-            for(Int i = 0; i < id; i++) {
-                tmpClause.push_back(variable.at(i));
+    if(lowerLimit > 0) {
+        if(row[lowerLimit] != 0) tmpClause.push_back(row[lowerLimit]);
+        addClause(tmpClause);
+    }
+}
+
+// s <--> previous \/ (xi /\ carried), where 0 is false and carried == xi stands for xi /\ true
+Int SWCEncoder::registerEncode(Int previous, Int xi, Int carried) {
+    if(carried == 0) return previous;
+    if(previous == 0) return carried == xi ? xi : defineAnd({xi, carried});
+    if(carried == xi) return defineOr({previous, xi});
+    return defineOrAnd(previous, xi, carried);
+}
+
+void GTEncoder::encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit) {
+    if(DEBUG) util::printConstraint(variable, coefficient, limit);
+    totalizerEncode(variable, coefficient, 0, limit);
+}
+
+void GTEncoder::encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    if(DEBUG) util::printConstraint(variable, coefficient, limit, lowerLimit);
+    totalizerEncode(variable, coefficient, lowerLimit, limit);
+}
+
+// generalized totalizer: every node holds (v, o_v) for each partial sum v > 0 its
+// subtree can reach, saturated at limit + 1, with o_v <--> subtree sum >= v. Leaves
+// are (a_i, x_i) and nodes are merged pairwise, level by level, up to the root
+void GTEncoder::totalizerEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit) {
+    Int sum = 0;
+    for(Int coef : coefficient) sum += coef;
+    if(limit >= sum && lowerLimit <= 0) return;
+    Int saturation = limit < sum ? limit + 1 : lowerLimit;    // only sum >= lowerLimit is asked when limit is never hit
+
+    vector<vector<Pair<Int, Int> > > level, nextLevel;
+    for(Int i = 0; i < variable.size(); i++) {
+        level.push_back({{std::min(coefficient.at(i), saturation), variable.at(i)}});
+    }
+    while(level.size() > 1) {
+        nextLevel.clear();
+        for(Int j = 0; j + 1 < level.size(); j += 2) {
+            nextLevel.push_back(nodeEncode(level[j], level[j + 1], saturation));
+        }
+        if(level.size() & 1) nextLevel.push_back(level.back());
+        level.swap(nextLevel);
+    }
+
+    const vector<Pair<Int, Int> > &root = level.front();
+    vector<Int> tmpClause;
+    if(root.back().first == saturation && limit < sum) {        // not (sum >= limit + 1)
+        tmpClause.push_back(-root.back().second);
+        addClause(tmpClause); tmpClause.clear();
+    }
+    if(lowerLimit > 0) {                                        // sum >= smallest reachable v >= lowerLimit
+        for(const Pair<Int, Int> &output : root) {
+            if(output.first >= lowerLimit) {
+                tmpClause.push_back(output.second);
+                break;
             }
-            tmpClause.push_back(getPair2AuxVar(str2AuxVar, id, w));
-            addClause(tmpClause);
-        } else if (w < 0) {
-            tmpClause.clear();
-            tmpClause.push_back(-getPair2AuxVar(str2AuxVar, id, w));
-            addClause(tmpClause);
-        } else if (w >= preSum.at(id)) {
-            tmpClause.clear();
-            tmpClause.push_back(getPair2AuxVar(str2AuxVar, id, w));
+        }
+        addClause(tmpClause);
+    }
+}
+
+// sum ax <= limit in mixed radix: position j counts its digit copies of the terms plus the carries
+// from position j-1, which are every base[j-1]-th output of that count. A constant offset makes
+// limit + 1 a multiple of the top weight, so only one output of the top sorter is asserted.
+void MixedRadixEncoder::encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit) {
+    if(DEBUG) util::printConstraint(variable, coefficient, limit);
+    vector<Int> base = selectBases(coefficient);
+    Int m = base.size();
+    vector<Int> weight(m + 1, 1);
+    for(Int j = 0; j < m; j++) weight[j + 1] = weight[j] * base[j];
+
+    Int offset = (weight[m] - (limit + 1) % weight[m]) % weight[m];
+    vector<Int> need(m + 1);   // only whether position j counts at least need[j] matters
+    need[m] = (limit + 1 + offset) / weight[m];
+    for(Int j = m - 1; j >= 0; j--) need[j] = need[j + 1] * base[j];
+
+    // count at position j >= t <--> t <= trueCnt or carry[t - trueCnt - 1]
+    Int trueCnt = 0;
+    vector<Int> carry, tmpClause;
+    for(Int j = 0; j <= m; j++) {
+        vector<Int> digitInput;
+        trueCnt += j < m ? offset / weight[j] % base[j] : offset / weight[j];
+        for(Int i = 0; i < variable.size(); i++) {
+            Int digit = j < m ? coefficient[i] / weight[j] % base[j] : coefficient[i] / weight[j];
+            digitInput.insert(digitInput.end(), digit, variable[i]);
+        }
+        if(need[j] <= trueCnt) {   // the constants alone reach the limit
             addClause(tmpClause);
-        } else {                    // D_{id, w} is not terminal node
-            if(str2AuxVar.find(pair2Str(id - 1, w - coefficient.at(id - 1))) == str2AuxVar.end()) {
-                unmarked.push({id - 1, w - coefficient.at(id - 1)});
-            }
-            if(str2AuxVar.find(pair2Str(id - 1, w)) == str2AuxVar.end()) {
-                unmarked.push({id - 1, w});
+            return;
+        }
+
+        Int outputCnt = std::min((Int)(digitInput.size() + carry.size()), need[j] - trueCnt);
+        vector<Int> output;
+        if(outputCnt > 0) output = countEncode(digitInput, carry, outputCnt);
+        if(j == m) {
+            if(need[j] - trueCnt <= outputCnt) {
+                tmpClause.push_back(-output[need[j] - trueCnt - 1]);
+                addClause(tmpClause);
             }
+            return;
+        }
 
+        Int nextTrueCnt = trueCnt / base[j];
+        carry.clear();
+        for(Int t = nextTrueCnt + 1; t * base[j] - trueCnt <= outputCnt; t++) {
+            carry.push_back(output[t * base[j] - trueCnt - 1]);
+        }
+        trueCnt = nextTrueCnt;
+    }
+}
 
-            tmpClause.clear();
-            tmpClause.push_back(-getPair2AuxVar(str2AuxVar, id - 1, w - coefficient.at(id - 1)));
-            tmpClause.push_back(getPair2AuxVar(str2AuxVar, id, w));
-            addClause(tmpClause);
+// greedily the base leaving the fewest digits, this position's plus those still to come, until no base helps
+vector<Int> MixedRadixEncoder::selectBases(const vector<Int> &coefficient) {
+    vector<Int> quotient(coefficient), base;
+    while(true) {
+        Int bestBase = 0, bestCost = 0;
+        for(Int qi : quotient) bestCost += qi;
+        for(Int b : MIXED_RADIX_BASES) {
+            Int cost = 0;
+            for(Int qi : quotient) cost += qi % b + qi / b;
+            if(cost < bestCost) {
+                bestBase = b;
+                bestCost = cost;
+            }
+        }
+        if(bestBase == 0) return base;
+        base.push_back(bestBase);
+        for(Int &qi : quotient) qi /= bestBase;
+    }
+}
 
-            tmpClause.clear();
-            tmpClause.push_back(-getPair2AuxVar(str2AuxVar, id, w));
-            tmpClause.push_back(getPair2AuxVar(str2AuxVar, id - 1, w));
-            addClause(tmpClause);
+// the digits are sorted and merged with the carries, which are sorted already
+vector<Int> MixedRadixEncoder::countEncode(const vector<Int> &digitInput, const vector<Int> &carry, Int outputCnt) {
+    return sortEncode(digitInput, outputCnt, {carry});
+}
 
-            tmpClause.clear();
-            tmpClause.push_back(-getPair2AuxVar(str2AuxVar, id, w));
-            tmpClause.push_back(-variable.at(id - 1));                   // x_i
-            tmpClause.push_back(getPair2AuxVar(str2AuxVar, id - 1, w - coefficient.at(id - 1)));
-            addClause(tmpClause);
+vector<Int> BinaryMergeEncoder::selectBases(const vector<Int> &coefficient) {
+    vector<Int> base;
+    for(Int maxQuotient = *std::max_element(coefficient.begin(), coefficient.end()); maxQuotient > 1; maxQuotient >>= 1) {
+        base.push_back(2);
+    }
+    return base;
+}
 
-            tmpClause.clear();
-            tmpClause.push_back(-getPair2AuxVar(str2AuxVar, id - 1, w));
-            tmpClause.push_back(variable.at(id - 1));
-            tmpClause.push_back(getPair2AuxVar(str2AuxVar, id, w));
-            addClause(tmpClause);
+// the digits by a totalizer whose root is merged with the carries by one more totalizer node
+vector<Int> WatchdogEncoder::countEncode(const vector<Int> &digitInput, const vector<Int> &carry, Int outputCnt) {
+    vector<vector<Pair<Int, Int> > > level, nextLevel;
+    for(Int xi : digitInput) level.push_back({{1, xi}});
+    while(level.size() > 1) {
+        nextLevel.clear();
+        for(Int j = 0; j + 1 < level.size(); j += 2) {
+            nextLevel.push_back(nodeEncode(level[j], level[j + 1], outputCnt));
         }
+        if(level.size() & 1) nextLevel.push_back(level.back());
+        level.swap(nextLevel);
     }
-}
\ No newline at end of file
+
+    vector<Pair<Int, Int> > root, carryNode;
+    if(!level.empty()) root = level.front();
+    for(Int t = 0; t < carry.size() && t < outputCnt; t++) carryNode.push_back({t + 1, carry[t]});
+    if(root.empty()) root.swap(carryNode);
+    else if(!carryNode.empty()) root = nodeEncode(root, carryNode, outputCnt);
+
+    vector<Int> output;
+    for(Int t = 0; t < outputCnt; t++) output.push_back(root[t].second);
+    return output;
+}
@@ -10,8 +10,20 @@ void OptionDict::printOptions() const {
 	cout << "\t  -" << INPUT_OPTION << "  arg  \t\targ: input file path \t\tRequired\n";
 	cout << "\t  -" << OUTPUT_OPTION << "  arg  \t\targ: output file path \t\tRequired\n";
     cout << "\t --" << WEIGHT_FORMAT_OPTION << " arg \t\targ: weight format option [default: 1, and 1-UNWEIGHTED 2-WEIGHTED]\n";
-    cout << "\t --" << OUTPUT_FORMAT_OPTION << " arg \t\targ: output format option [default: 1, and 1-MC20 2-MC21]\n";
-    cout << "\t --" << ENCODER_OPTION << " arg \t\targ: encoder option [default: 1, and 1-Warners 2-GenArc]\n";
+    cout << "\t --" << OUTPUT_FORMAT_OPTION << " arg \t\targ: output format option [default: 1, and 1-MC20 2-MC21 3-AIGER]\n";
+    cout << "\t --" << ENCODER_OPTION << " arg \t\targ: encoder option [default: 1, and 1-Warners 2-GenArc 3-Hybrid 4-SWC 5-GT 6-MixedRadix 7-BinaryMerge 8-Watchdog]\n";
+    cout << "\t --" << WARNERS_TREE_OPTION << " arg \t\targ: Warners adder tree option [default: 1, and 1-Balanced 2-Huffman 3-CarrySave]\n";
+    cout << "\t --" << SHARE_SUBSUM_OPTION << " arg \t\targ: share sub-sums across Warners constraints [default: 0, and 0-off 1-on]\n";
+    cout << "\t --" << SHARE_LHS_OPTION << " arg \t\targ: one Warners adder for constraints with the same LHS [default: 1, and 0-off 1-on]\n";
+    cout << "\t --" << WARNERS_COMPARATOR_OPTION << " arg \t\targ: Warners comparator option [default: 1, and 1-Clauses 2-Offset]\n";
+    cout << "\t --" << SATURATE_OPTION << " arg \t\targ: cut Warners partial sums to the bits the limit needs [default: 1, and 0-off 1-on]\n";
+    cout << "\t --" << GROUP_COEFFICIENT_OPTION << " arg \t\targ: count Warners terms with the same coefficient in binary first [default: 1, and 0-off 1-on]\n";
+    cout << "\t --" << HYBRID_THRESHOLD_OPTION << " arg \t\targ: Hybrid encodes constraints with more terms in blocks [default: " << DEFAULT_HYBRID_THRESHOLD_CHOICE << "]\n";
+    cout << "\t --" << CARDINALITY_NETWORK_OPTION << " arg \t\targ: sorting network for constraints with all coefficients 1 [default: 0, and 0-off 1-on]\n";
+    cout << "\t --" << AT_MOST_ONE_OPTION << " arg \t\targ: pairwise or ladder clauses for at-most-one and exactly-one [default: 1, and 0-off 1-on]\n";
+    cout << "\t --" << PRIME_IMPLICATE_OPTION << " arg \t\targ: prime implicates with no aux var for constraints up to arg terms [default: " << DEFAULT_PRIME_IMPLICATE_CHOICE << ", and 0-off]\n";
+    cout << "\t --" << INDEPENDENT_SUPPORT_OPTION << " arg \t\targ: list the original vars as independent support (c ind, c p show) [default: 1, and 0-off 1-on]\n";
+    cout << "\t --" << XOR_OUTPUT_OPTION << " arg \t\targ: xor gates as extended DIMACS x lines instead of clauses [default: 0, and 0-off 1-on]\n";
 }
 
 void OptionDict::printWelcome() const {
@@ -40,7 +52,19 @@ OptionDict::OptionDict(int argc, char *argv[]) {
         (HELP_OPTION, "help")
         (WEIGHT_FORMAT_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_PBWEIGHT_FORMAT_CHOICE)))
         (OUTPUT_FORMAT_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_OUTPUT_FORMAT_CHOICE)))
-        (ENCODER_OPTION, "",  cxxopts::value<string>()->default_value(to_string(DEFAULT_PBWEIGHT_FORMAT_CHOICE)));
+        (ENCODER_OPTION, "",  cxxopts::value<string>()->default_value(to_string(DEFAULT_ENCODER_CHOICE)))
+        (WARNERS_TREE_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_WARNERS_TREE_CHOICE)))
+        (SHARE_SUBSUM_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_SHARE_SUBSUM_CHOICE)))
+        (SHARE_LHS_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_SHARE_LHS_CHOICE)))
+        (WARNERS_COMPARATOR_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_WARNERS_COMPARATOR_CHOICE)))
+        (SATURATE_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_SATURATE_CHOICE)))
+        (GROUP_COEFFICIENT_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_GROUP_COEFFICIENT_CHOICE)))
+        (HYBRID_THRESHOLD_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_HYBRID_THRESHOLD_CHOICE)))
+        (CARDINALITY_NETWORK_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_CARDINALITY_NETWORK_CHOICE)))
+        (AT_MOST_ONE_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_AT_MOST_ONE_CHOICE)))
+        (PRIME_IMPLICATE_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_PRIME_IMPLICATE_CHOICE)))
+        (XOR_OUTPUT_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_XOR_OUTPUT_CHOICE)))
+        (INDEPENDENT_SUPPORT_OPTION, "", cxxopts::value<string>()->default_value(to_string(DEFAULT_INDEPENDENT_SUPPORT_CHOICE)))
         ;
 
     cxxopts::ParseResult result = options->parse(argc, argv);
@@ -54,6 +78,18 @@ OptionDict::OptionDict(int argc, char *argv[]) {
     weightFormat = PBWEIGHT_FORMAT_CHOICES.at(stoll(result[WEIGHT_FORMAT_OPTION].as<string>()));
     outputFormat = OUTPUT_FORMAT_CHOICES.at(stoll(result[OUTPUT_FORMAT_OPTION].as<string>()));
     encoderType = ENCODER_CHOICES.at(stoll(result[ENCODER_OPTION].as<string>()));
+    warnersTreeStrategy = WARNERS_TREE_CHOICES.at(stoll(result[WARNERS_TREE_OPTION].as<string>()));
+    shareSubSums = stoll(result[SHARE_SUBSUM_OPTION].as<string>()) != 0;
+    shareLhs = stoll(result[SHARE_LHS_OPTION].as<string>()) != 0;
+    warnersComparator = WARNERS_COMPARATOR_CHOICES.at(stoll(result[WARNERS_COMPARATOR_OPTION].as<string>()));
+    saturate = stoll(result[SATURATE_OPTION].as<string>()) != 0;
+    groupCoefficients = stoll(result[GROUP_COEFFICIENT_OPTION].as<string>()) != 0;
+    hybridThreshold = stoll(result[HYBRID_THRESHOLD_OPTION].as<string>());
+    cardinalityNetwork = stoll(result[CARDINALITY_NETWORK_OPTION].as<string>()) != 0;
+    atMostOne = stoll(result[AT_MOST_ONE_OPTION].as<string>()) != 0;
+    primeImplicateTerms = stoll(result[PRIME_IMPLICATE_OPTION].as<string>());
+    xorOutput = stoll(result[XOR_OUTPUT_OPTION].as<string>()) != 0;
+    independentSupport = stoll(result[INDEPENDENT_SUPPORT_OPTION].as<string>()) != 0;
 }
 
 int main(int argc, char **argv){
@@ -67,15 +103,42 @@ int main(int argc, char **argv){
         util::printComment("pid " + to_string(getpid()));
         Pbf pbf(optionDict.input_file, optionDict.weightFormat);
 
-        if(optionDict.encoderType == EncoderType::Warners) {
-            WarnersEncoder encoder;
-            encoder.encodePbf(pbf);
-            encoder.printCnf(optionDict.output_file, optionDict.outputFormat);
-        } else if(optionDict.encoderType == EncoderType::GenArc) {
-            GenArcEncoder encoder;
-            encoder.encodePbf(pbf);
-            encoder.printCnf(optionDict.output_file, optionDict.outputFormat);
-        } 
+        Encoder *encoder = nullptr;
+        switch(optionDict.encoderType) {
+            case EncoderType::Warners:
+                encoder = new WarnersEncoder(optionDict.warnersTreeStrategy, optionDict.shareSubSums, optionDict.shareLhs, optionDict.groupCoefficients, optionDict.warnersComparator, optionDict.saturate);
+                break;
+            case EncoderType::GenArc:
+                encoder = new GenArcEncoder();
+                break;
+            case EncoderType::Hybrid:
+                encoder = new HybridEncoder(optionDict.warnersTreeStrategy, optionDict.shareSubSums, optionDict.shareLhs, optionDict.groupCoefficients, optionDict.warnersComparator, optionDict.saturate, optionDict.hybridThreshold);
+                break;
+            case EncoderType::SWC:
+                encoder = new SWCEncoder();
+                break;
+            case EncoderType::GT:
+                encoder = new GTEncoder();
+                break;
+            case EncoderType::MixedRadix:
+                encoder = new MixedRadixEncoder();
+                break;
+            case EncoderType::BinaryMerge:
+                encoder = new BinaryMergeEncoder();
+                break;
+            case EncoderType::Watchdog:
+                encoder = new WatchdogEncoder();
+                break;
+        }
+        encoder->setCardinalityNetwork(optionDict.cardinalityNetwork);
+        encoder->setAtMostOne(optionDict.atMostOne);
+        encoder->setPrimeImplicateTerms(optionDict.primeImplicateTerms);
+        encoder->setXorOutput(optionDict.xorOutput);
+        encoder->setIndependentSupport(optionDict.independentSupport);
+        encoder->encodePbf(pbf);
+        encoder->printStats();
+        encoder->printCnf(optionDict.output_file, optionDict.outputFormat);
+        delete encoder;
     }
 
     return 0;
@@ -26,10 +26,11 @@ void Pbf::updateApparentVars(Int literal) {
         apparentVars.push_back(var);
 }
 
-void Pbf::addConstraint(const vector<Int>& variable, const vector<Int>& coefficient, const Int& limit) {
+void Pbf::addConstraint(const vector<Int>& variable, const vector<Int>& coefficient, const Int& limit, const Int& lowerLimit) {
     variables.push_back(variable);
     coefficients.push_back(coefficient);
     limits.push_back(limit);
+    lowerLimits.push_back(lowerLimit);
 
     for (Int literal : variable) {
         updateApparentVars(literal);
@@ -75,6 +76,10 @@ const vector<Int>& Pbf::getLimits() const {
     return limits;
 }
 
+const vector<Int>& Pbf::getLowerLimits() const {
+    return lowerLimits;
+}
+
 const vector<Int>& Pbf::getApparentVars() const {
     return apparentVars;
 }
@@ -144,12 +149,13 @@ Pbf::Pbf(const string& filePath, PBWeightFormat weightFormat) {
                 if(endLineFlag && i != wordCount - 1) util::showError("External words after relation limit " + words.at(i));
 
                 const string &nowWord = words.at(i);
-                if(nowWord == EQUAL_WORD) {                     // == need format & inverse
+                if(nowWord == EQUAL_WORD) {                     // == need format, kept as range [limit, limit]
                     limit = std::stoll(words.at(++i));          // now i = i+1
                     util::formatConstraint(clause, coefficient, limit);
-                    addConstraint(clause, coefficient, limit);
-                    util::inverseConstraint(clause, coefficient, limit);
-                    addConstraint(clause, coefficient, limit);
+                    Int sum = 0;
+                    for (Int coef : coefficient) sum += coef;
+                    if (limit > sum) util::showError("Formula <= negative limit");
+                    addConstraint(clause, coefficient, limit, limit);
                     endLineFlag = true;
                 } else if(nowWord == GEQUAL_WORD) {             // >= need inverse
                     limit = std::stoll(words.at(++i));          // now i = i+1
@@ -197,6 +203,7 @@ Pbf::Pbf(const vector<vector<Int>>& variables, const vector<vector<Int>> &coeffi
     this->variables = variables;
     this->coefficients = coefficients;
     this->limits = limits;
+    this->lowerLimits.assign(limits.size(), 0);
 
     for (const vector<Int>& clause : variables) {
         for (Int literal : clause) {
@@ -35,6 +35,18 @@ const string& OUTPUT_OPTION = "O";
 const string& WEIGHT_FORMAT_OPTION = "wf";
 const string& ENCODER_OPTION = "ed";
 const string& OUTPUT_FORMAT_OPTION = "of";
+const string& WARNERS_TREE_OPTION = "wt";
+const string& SHARE_SUBSUM_OPTION = "ss";
+const string& SHARE_LHS_OPTION = "sl";
+const string& GROUP_COEFFICIENT_OPTION = "gc";
+const string& WARNERS_COMPARATOR_OPTION = "wc";
+const string& SATURATE_OPTION = "sa";
+const string& HYBRID_THRESHOLD_OPTION = "ht";
+const string& CARDINALITY_NETWORK_OPTION = "cn";
+const string& AT_MOST_ONE_OPTION = "am";
+const string& PRIME_IMPLICATE_OPTION = "pi";
+const string& XOR_OUTPUT_OPTION = "xo";
+const string& INDEPENDENT_SUPPORT_OPTION = "is";
 
 const std::map<Int, PBWeightFormat> PBWEIGHT_FORMAT_CHOICES = {
     {1, PBWeightFormat::UNWEIGHTED},
@@ -43,14 +55,89 @@ const Int DEFAULT_PBWEIGHT_FORMAT_CHOICE = 1;
 
 const std::map<Int, OutputFormat> OUTPUT_FORMAT_CHOICES = {
     {1, OutputFormat::MC20},
-    {2, OutputFormat::MC21}};
+    {2, OutputFormat::MC21},
+    {3, OutputFormat::AIGER}};
 const Int DEFAULT_OUTPUT_FORMAT_CHOICE = 1;
 
 const std::map<Int, EncoderType> ENCODER_CHOICES = {
     {1, EncoderType::Warners},
-    {2, EncoderType::GenArc}};
+    {2, EncoderType::GenArc},
+    {3, EncoderType::Hybrid},
+    {4, EncoderType::SWC},
+    {5, EncoderType::GT},
+    {6, EncoderType::MixedRadix},
+    {7, EncoderType::BinaryMerge},
+    {8, EncoderType::Watchdog}};
 const Int DEFAULT_ENCODER_CHOICE = 1;
 
+const std::map<Int, WarnersTreeStrategy> WARNERS_TREE_CHOICES = {
+    {1, WarnersTreeStrategy::Balanced},
+    {2, WarnersTreeStrategy::Huffman},
+    {3, WarnersTreeStrategy::CarrySave}};
+const Int DEFAULT_WARNERS_TREE_CHOICE = 1;
+
+const std::map<Int, WarnersComparator> WARNERS_COMPARATOR_CHOICES = {
+    {1, WarnersComparator::Clauses},
+    {2, WarnersComparator::Offset}};
+const Int DEFAULT_WARNERS_COMPARATOR_CHOICE = 1;
+
+const Int DEFAULT_SHARE_SUBSUM_CHOICE = 0;
+const Int DEFAULT_SHARE_LHS_CHOICE = 1;
+const Int DEFAULT_GROUP_COEFFICIENT_CHOICE = 1;
+const Int DEFAULT_SATURATE_CHOICE = 1;
+const Int COEFFICIENT_GROUP_MIN_SIZE = 3;   // smaller groups are left as single terms
+
+const Int DEFAULT_HYBRID_THRESHOLD_CHOICE = 64;  // constraints with more terms are split into blocks
+const Int HYBRID_BLOCK_SIZE = 16;
+
+const Int DEFAULT_CARDINALITY_NETWORK_CHOICE = 0;
+const Int DEFAULT_AT_MOST_ONE_CHOICE = 1;
+const Int AT_MOST_ONE_PAIRWISE_SIZE = 6;   // up to here pairwise clauses are no more than the ladder
+const Int DEFAULT_PRIME_IMPLICATE_CHOICE = 10;  // constraints with at most this many terms may be written as their prime implicates
+const Int PRIME_IMPLICATE_MAX_CLAUSES = 64;
+const Int DEFAULT_XOR_OUTPUT_CHOICE = 0;
+const Int DEFAULT_INDEPENDENT_SUPPORT_CHOICE = 1;
+const Int INDEPENDENT_SUPPORT_LINE_SIZE = 100;   // vars per c ind / c p show line
+
+const vector<Int> MIXED_RADIX_BASES = {2, 3, 5, 7, 11, 13, 17};
+// optimal known comparator networks, comparator {i, j} leaves the smaller value on wire i
+const std::map<Int, vector<Pair<Int, Int> > > SORTING_NETWORKS = {
+    {2, {{0, 1}}},
+    {3, {{0, 2}, {0, 1}, {1, 2}}},
+    {4, {{0, 1}, {2, 3}, {0, 2}, {1, 3}, {1, 2}}},
+    {5, {{0, 3}, {1, 4}, {0, 2}, {1, 3}, {0, 1}, {2, 4}, {1, 2}, {3, 4}, {2, 3}}},
+    {6, {{0, 5}, {1, 3}, {2, 4}, {1, 2}, {3, 4}, {0, 3}, {2, 5}, {0, 1}, {2, 3}, {4, 5},
+        {1, 2}, {3, 4}}},
+    {7, {{0, 6}, {2, 3}, {4, 5}, {0, 2}, {1, 4}, {3, 6}, {0, 1}, {2, 5}, {3, 4}, {1, 2},
+        {4, 6}, {2, 3}, {4, 5}, {1, 2}, {3, 4}, {5, 6}}},
+    {8, {{0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}, {0, 1}, {2, 3},
+        {4, 5}, {6, 7}, {2, 4}, {3, 5}, {1, 4}, {3, 6}, {1, 2}, {3, 4}, {5, 6}}},
+    {9, {{0, 3}, {1, 7}, {2, 5}, {4, 8}, {0, 7}, {2, 4}, {3, 8}, {5, 6}, {0, 2}, {1, 3},
+        {4, 5}, {7, 8}, {1, 4}, {3, 6}, {5, 7}, {0, 1}, {2, 4}, {3, 5}, {6, 8}, {2, 3},
+        {4, 5}, {6, 7}, {1, 2}, {3, 4}, {5, 6}}},
+    {10, {{0, 8}, {1, 9}, {2, 7}, {3, 5}, {4, 6}, {0, 2}, {1, 4}, {5, 8}, {7, 9}, {0, 3},
+        {2, 4}, {5, 7}, {6, 9}, {0, 1}, {3, 6}, {8, 9}, {1, 5}, {2, 3}, {4, 8}, {6, 7},
+        {1, 2}, {3, 5}, {4, 6}, {7, 8}, {2, 3}, {4, 5}, {6, 7}, {3, 4}, {5, 6}}},
+    {11, {{0, 9}, {1, 6}, {2, 4}, {3, 7}, {5, 8}, {0, 1}, {3, 5}, {4, 10}, {6, 9}, {7, 8},
+        {1, 3}, {2, 5}, {4, 7}, {8, 10}, {0, 4}, {1, 2}, {3, 7}, {5, 9}, {6, 8}, {0, 1},
+        {2, 6}, {4, 5}, {7, 8}, {9, 10}, {2, 4}, {3, 6}, {5, 7}, {8, 9}, {1, 2}, {3, 4},
+        {5, 6}, {7, 8}, {2, 3}, {4, 5}, {6, 7}}},
+    {12, {{0, 8}, {1, 7}, {2, 6}, {3, 11}, {4, 10}, {5, 9}, {0, 1}, {2, 5}, {3, 4}, {6, 9},
+        {7, 8}, {10, 11}, {0, 2}, {1, 6}, {5, 10}, {9, 11}, {0, 3}, {1, 2}, {4, 6}, {5, 7},
+        {8, 11}, {9, 10}, {1, 4}, {3, 5}, {6, 8}, {7, 10}, {1, 3}, {2, 5}, {6, 9}, {8, 10},
+        {2, 3}, {4, 5}, {6, 7}, {8, 9}, {4, 6}, {5, 7}, {3, 4}, {5, 6}, {7, 8}}},
+    {13, {{0, 12}, {1, 10}, {2, 9}, {3, 7}, {5, 11}, {6, 8}, {1, 6}, {2, 3}, {4, 11}, {7, 9},
+        {8, 10}, {0, 4}, {1, 2}, {3, 6}, {7, 8}, {9, 10}, {11, 12}, {4, 6}, {5, 9}, {8, 11},
+        {10, 12}, {0, 5}, {3, 8}, {4, 7}, {6, 11}, {9, 10}, {0, 1}, {2, 5}, {6, 9}, {7, 8},
+        {10, 11}, {1, 3}, {2, 4}, {5, 6}, {9, 10}, {1, 2}, {3, 4}, {5, 7}, {6, 8}, {2, 3},
+        {4, 5}, {6, 7}, {8, 9}, {3, 4}, {5, 6}}},
+    {16, {{0, 13}, {1, 12}, {2, 15}, {3, 14}, {4, 8}, {5, 6}, {7, 11}, {9, 10}, {0, 5}, {1, 7},
+        {2, 9}, {3, 4}, {6, 13}, {8, 14}, {10, 15}, {11, 12}, {0, 1}, {2, 3}, {4, 5}, {6, 8},
+        {7, 9}, {10, 11}, {12, 13}, {14, 15}, {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9},
+        {12, 14}, {13, 15}, {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {13, 14}, {1, 4},
+        {2, 6}, {5, 8}, {7, 10}, {9, 13}, {11, 14}, {2, 4}, {3, 6}, {9, 12}, {11, 13}, {3, 5},
+        {6, 8}, {7, 9}, {10, 12}, {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12}, {6, 7}, {8, 9}}}};
+
 const Int DEFAULT_RANDOM_SEED = 10;
 
 const Float NEGATIVE_INFINITY = -std::numeric_limits<Float>::infinity();
@@ -261,11 +348,12 @@ void util::inverseConstraint(vector<Int>& clause, vector<Int>& coefficient, Int&
         showError("Formula <= negative limit");
 }
 
-void util::printConstraint(const vector<Int>& clause, const vector<Int>& coefficent, const Int& limit) {
+void util::printConstraint(const vector<Int>& clause, const vector<Int>& coefficent, const Int& limit, const Int& lowerLimit) {
     for (int i = 0; i < clause.size(); i++) {
         cout << std::right << std::setw(5) << coefficent.at(i) << " x" << clause.at(i) << " ";
     }
     cout << std::right << std::setw(10) << " <= " << limit;
+    if (lowerLimit > 0) cout << "  >= " << lowerLimit;
     cout << "\n";
 }
 
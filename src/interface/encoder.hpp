@@ -1,45 +1,195 @@
 #include "pbformula.hpp"
 
+enum class GateType {And, Or, Xor, Xor3, Majority, Ite, OrAnd, Merge};
+
+// output <--> type(inputs), kept as a gate until the output writer expands it to clauses
+struct Gate {
+    GateType type;
+    Int output;
+    Int firstInput, inputCnt;       // range of Encoder::gateOperands
+};
+
 class Encoder {
 protected:
     vector<vector<Int> > clauses;
+    vector<Gate> gates;
+    vector<Int> gateOperands;
+    std::map<vector<Int>, Int> gateTable;   // (type, canonical inputs) -> output, one var per distinct gate
+    Int falseVar;                           // 0 until a constant is first needed
     Int varCnt, clauseCnt;
+    Int apparentVarCnt;
+    Float encodeSeconds;
     PBWeightFormat weightFormat;
     Map<Int, Float> literalWeights;
+    bool cardinalityNetwork, atMostOne, xorOutput, independentSupport;
+    Int primeImplicateTerms;
+    Map<string, vector<vector<Int> > > implicateShapes;   // minimal covers by coefficients and limit
+    Set<string> largeShapes;                              // shapes with too many of them
 
     void addClause(vector<Int> &clause);
+    void addGate(GateType type, Int output, const vector<Int> &inputs);
+    void gateClauses(const Gate &gate, vector<vector<Int> > &gateClause) const;
+    void printClauses(std::ofstream &outfile) const;
+    Int outputClauseCnt() const;
+    void printIndependentSupport(std::ofstream &outfile, const string &prefix) const;
     virtual void encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit) = 0;
+    virtual void encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+    virtual void encodeConstraints(const vector<vector<Int> > &variables, const vector<vector<Int> > &coefficients, const vector<Int> &lowerLimits, const vector<Int> &limits);
+    static Int comparedBound(Int sum, Int lowerLimit, Int limit);
+    virtual bool preferComplement(Int sum, Int lowerLimit, Int limit);
     Int getNewAuxVar();
-    void printWeightClauseMC20(std::ofstream &outfile) const;
+    Int getFalseVar();
+    Int defineGate(GateType type, vector<Int> inputs);
+    Int defineAnd(const vector<Int> &inputs);
+    Int defineOr(const vector<Int> &inputs);
+    Int defineXor(Int a, Int b);
+    Int defineXor3(Int a, Int b, Int c);
+    Int defineMajority(Int a, Int b, Int c);
+    Int defineIte(Int x, Int hi, Int lo);
+    Int defineOrAnd(Int a, Int b, Int c);
+    Int defineMerge(const vector<Int> &pairs);
+    string pair2Str(Int id, Int w);
+    Int diagramEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit, Map<string, Int> &str2AuxVar);
+    bool directClauses(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit, vector<vector<Int> > &directClause);
+    bool directEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+    bool minimalCovers(const vector<Int> &sortedCoefficient, const Int &limit, vector<vector<Int> > &cover);
+    bool implicateClauses(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit, vector<vector<Int> > &implicateClause);
+    bool primeImplicateEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+    bool encodeSpecialConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+    void atMostOneEncode(const vector<Int>& variable, bool exactlyOne);
+    void cardinalityEncode(const vector<Int>& variable, const Int &lowerLimit, const Int &limit);
+    vector<Pair<Int, Int> > oddEvenMergeNetwork(Int wireCnt, Int firstBlock);
+    vector<Int> sortEncode(const vector<Int>& literal, Int outputCnt, const vector<vector<Int> > &sortedLiteral = {});
+    vector<Pair<Int, Int> > nodeEncode(const vector<Pair<Int, Int> > &nodeA, const vector<Pair<Int, Int> > &nodeB, Int saturation);
+    void printWeightClauseMC20(std::ofstream &outfile, Int weightedVarCnt) const;
     void printWeightClauseMC21(std::ofstream &outfile) const;
     void printCnfMC20(const string &filepath) const;
     void printCnfMC21(const string &filepath) const;
+    void printAiger(const string &filepath) const;
 
 public:
     void printCnf(const string &filepath, OutputFormat outputFormat) const;
+    void printStats() const;
     void encodePbf(const Pbf &pbf);
-    Encoder(){};
+    void setCardinalityNetwork(bool cardinalityNetwork) { this->cardinalityNetwork = cardinalityNetwork; }
+    void setAtMostOne(bool atMostOne) { this->atMostOne = atMostOne; }
+    void setPrimeImplicateTerms(Int primeImplicateTerms) { this->primeImplicateTerms = primeImplicateTerms; }
+    void setXorOutput(bool xorOutput) { this->xorOutput = xorOutput; }
+    void setIndependentSupport(bool independentSupport) { this->independentSupport = independentSupport; }
+    Encoder() : falseVar(0), cardinalityNetwork(false), atMostOne(true), xorOutput(false), independentSupport(true), primeImplicateTerms(DEFAULT_PRIME_IMPLICATE_CHOICE) {};
+    virtual ~Encoder(){};
 };
 
 
 class WarnersEncoder : public Encoder {
 protected:
+    WarnersTreeStrategy treeStrategy;
+    WarnersComparator comparator;
+    bool shareSubSums, shareLhs, groupCoefficients, saturate;
+    Int saturationBits;     // 0, or partial sums are cut to that many bits plus a flag for >= 2^saturationBits
     Int maxCoefficient, coefficientBit;
+    vector<vector<Int> > sharedVariables, sharedCoefficients;   // terms of each shared sub-sum
+    vector<vector<Int> > sharedAuxVars;                         // output bits, empty until first use
+    vector<vector<Int> > constraintShares;                      // shared sub-sums used by each constraint
+    vector<vector<Int> > constraintTerms;                       // terms of each constraint left to itself
     void encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit);
-    vector<Int> intervalEncode(const vector<Int>& variable, const vector<Int> &coefficient, Int left, Int right);
+    void encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+    void encodeConstraints(const vector<vector<Int> > &variables, const vector<vector<Int> > &coefficients, const vector<Int> &lowerLimits, const vector<Int> &limits);
+    void findSharedLhs(const vector<vector<Int> > &variables, const vector<vector<Int> > &coefficients, vector<vector<Int> > &lhsConstraints, vector<bool> &flipped);
+    void findSharedSubSums(const vector<vector<Int> > &variables, const vector<vector<Int> > &coefficients);
+    vector<Int> sharedTermsEncode(Int i, const vector<Int>& variable, const vector<Int> &coefficient);
+    virtual vector<Int> termsEncode(const vector<Int>& variable, const vector<Int> &coefficient);
+    vector<Int> treeEncode(const vector<Int>& variable, const vector<Int> &coefficient);
+    vector<vector<Int> > disjointBins(const vector<Int> &coefficient);
+    vector<Int> disjointRow(const vector<Int>& variable, const vector<Int> &coefficient, const vector<Int> &bin);
+    bool groupEncode(const vector<Int>& variable, const vector<Int> &coefficient, vector<Int> &groupedVariable, vector<Int> &groupedCoefficient);
+    void setSaturation(Int sum, Int need);
+    vector<Int> levelEncode(const vector<Int>& variable, const vector<Int> &coefficient);
+    vector<Int> huffmanEncode(const vector<Int>& variable, const vector<Int> &coefficient);
+    vector<Int> carrySaveEncode(const vector<Int>& variable, const vector<Int> &coefficient);
+    vector<Int> rowBits(const vector<Int> &row);
+    vector<Int> combineEncode(vector<Pair<Int, vector<Int> > > &subtrees);
+    vector<Int> leafEncode(Int xi, Int ai, Int bitWidth);
+    vector<Int> saturatedLeafEncode(Int xi, Int ai, Int bitWidth);
+    vector<Int> adderEncode(vector<Int> &auxVarsL, vector<Int> &auxVarsR);
+    vector<Int> saturatedAdderEncode(vector<Int> auxVarsL, vector<Int> auxVarsR);
+    vector<Int> saturateBits(const vector<Int> &bits);
     void limitEncode(Int limit, vector<Int>& auxVar);
+    Int overflowEncode(Int constant, const vector<Int> &auxVars);
+    void geqEncode(Int bound, vector<Int>& auxVar);
     void weightEncode();
 
 public:
-    WarnersEncoder(){};
+    WarnersEncoder(WarnersTreeStrategy treeStrategy = WarnersTreeStrategy::Balanced, bool shareSubSums = false, bool shareLhs = true, bool groupCoefficients = true,
+                   WarnersComparator comparator = WarnersComparator::Clauses, bool saturate = true)
+        : treeStrategy(treeStrategy), comparator(comparator), shareSubSums(shareSubSums), shareLhs(shareLhs), groupCoefficients(groupCoefficients),
+          saturate(saturate), saturationBits(0) {};
 };
 
 
 class GenArcEncoder : public Encoder {
 protected:
-    string pair2Str(Int id, Int w);
-    Int getPair2AuxVar(Map<string, Int> &str2AuxVar, Int id, Int w);
     void encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit);
+    void encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+    bool preferComplement(Int, Int, Int) override { return false; }  // both ends of the diagram are cut already, the complement only adds and gates at its w == 0 terminals
 public:
     GenArcEncoder(){};
-};
\ No newline at end of file
+};
+
+
+class HybridEncoder : public WarnersEncoder {
+protected:
+    Int hybridThreshold;
+    vector<Int> termsEncode(const vector<Int>& variable, const vector<Int> &coefficient);
+    vector<Int> unaryBlockEncode(const vector<Int>& variable, const vector<Int> &coefficient);
+
+public:
+    HybridEncoder(WarnersTreeStrategy treeStrategy, bool shareSubSums, bool shareLhs, bool groupCoefficients, WarnersComparator comparator, bool saturate, Int hybridThreshold)
+        : WarnersEncoder(treeStrategy, shareSubSums, shareLhs, groupCoefficients, comparator, saturate), hybridThreshold(hybridThreshold) {};
+};
+
+class SWCEncoder : public Encoder {
+protected:
+    void encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit);
+    void encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+    void counterEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+    Int registerEncode(Int previous, Int xi, Int carried);
+public:
+    SWCEncoder(){};
+};
+
+
+class GTEncoder : public Encoder {
+protected:
+    void encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit);
+    void encodeRangeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+    void totalizerEncode(const vector<Int>& variable, const vector<Int> &coefficient, const Int &lowerLimit, const Int &limit);
+public:
+    GTEncoder(){};
+};
+
+
+class MixedRadixEncoder : public Encoder {
+protected:
+    void encodeConstraint(const vector<Int>& variable, const vector<Int> &coefficient, const Int &limit);
+    virtual vector<Int> selectBases(const vector<Int> &coefficient);
+    virtual vector<Int> countEncode(const vector<Int> &digitInput, const vector<Int> &carry, Int outputCnt);
+public:
+    MixedRadixEncoder(){};
+};
+
+
+class BinaryMergeEncoder : public MixedRadixEncoder {
+protected:
+    vector<Int> selectBases(const vector<Int> &coefficient);
+public:
+    BinaryMergeEncoder(){};
+};
+
+
+class WatchdogEncoder : public BinaryMergeEncoder {
+protected:
+    vector<Int> countEncode(const vector<Int> &digitInput, const vector<Int> &carry, Int outputCnt);
+public:
+    WatchdogEncoder(){};
+};
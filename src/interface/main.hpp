@@ -11,6 +11,18 @@ public:
     PBWeightFormat weightFormat;
     OutputFormat outputFormat;
     EncoderType encoderType;
+    WarnersTreeStrategy warnersTreeStrategy;
+    bool shareSubSums;
+    bool shareLhs;
+    bool groupCoefficients;
+    WarnersComparator warnersComparator;
+    bool saturate;
+    Int hybridThreshold;
+    bool cardinalityNetwork;
+    bool atMostOne;
+    Int primeImplicateTerms;
+    bool xorOutput;
+    bool independentSupport;
 
     cxxopts::Options *options;
 
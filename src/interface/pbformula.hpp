@@ -25,10 +25,11 @@ protected:
     vector<vector<Int> > variables;
     vector<vector<Int> > coefficients;
     vector<Int> limits;
+    vector<Int> lowerLimits; // constraint i is lowerLimits[i] <= sum <= limits[i], 0 unless it came from "="
     vector<Int> apparentVars; // vars appearing in clauses, ordered by 1st appearance
     
     void updateApparentVars(Int literal); // adds var to apparentVars
-    void addConstraint(const vector<Int> &variables, const vector<Int> &coefficent, const Int &limit); // writes: variables, apparentVars
+    void addConstraint(const vector<Int> &variables, const vector<Int> &coefficent, const Int &limit, const Int &lowerLimit = 0); // writes: variables, apparentVars
 
 public:
     Int getDeclaredVarCount() const;
@@ -39,6 +40,7 @@ public:
     const vector<vector<Int>> &getVariables() const;
     const vector<vector<Int>> &getCoefficients() const;
     const vector<Int> &getLimits() const;
+    const vector<Int> &getLowerLimits() const;
     const vector<Int> &getApparentVars() const;
     void printConstraints() const;
     void sortConstraintsByOrdering();
@@ -7,11 +7,13 @@
 #include <chrono>
 #include <deque>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <random>
+#include <set>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -72,20 +74,61 @@ extern const string& OUTPUT_OPTION;
 extern const string& WEIGHT_FORMAT_OPTION;
 extern const string& ENCODER_OPTION;
 extern const string& OUTPUT_FORMAT_OPTION;
+extern const string& WARNERS_TREE_OPTION;
+extern const string& SHARE_SUBSUM_OPTION;
+extern const string& SHARE_LHS_OPTION;
+extern const string& GROUP_COEFFICIENT_OPTION;
+extern const string& WARNERS_COMPARATOR_OPTION;
+extern const string& SATURATE_OPTION;
+extern const string& HYBRID_THRESHOLD_OPTION;
+extern const string& CARDINALITY_NETWORK_OPTION;
+extern const string& AT_MOST_ONE_OPTION;
+extern const string& PRIME_IMPLICATE_OPTION;
+extern const string& XOR_OUTPUT_OPTION;
+extern const string& INDEPENDENT_SUPPORT_OPTION;
 
 enum class PBWeightFormat { UNWEIGHTED,
                             WEIGHTED };
 extern const std::map<Int, PBWeightFormat> PBWEIGHT_FORMAT_CHOICES;
 extern const Int DEFAULT_PBWEIGHT_FORMAT_CHOICE;
 
-enum class OutputFormat {MC20, MC21};
+enum class OutputFormat {MC20, MC21, AIGER};
 extern const std::map<Int, OutputFormat> OUTPUT_FORMAT_CHOICES;
 extern const Int DEFAULT_OUTPUT_FORMAT_CHOICE;
 
-enum class EncoderType {Warners, GenArc};
+enum class EncoderType {Warners, GenArc, Hybrid, SWC, GT, MixedRadix, BinaryMerge, Watchdog};
 extern const std::map<Int, EncoderType> ENCODER_CHOICES;
 extern const Int DEFAULT_ENCODER_CHOICE;
 
+enum class WarnersTreeStrategy {Balanced, Huffman, CarrySave};
+extern const std::map<Int, WarnersTreeStrategy> WARNERS_TREE_CHOICES;
+extern const Int DEFAULT_WARNERS_TREE_CHOICE;
+
+enum class WarnersComparator {Clauses, Offset};
+extern const std::map<Int, WarnersComparator> WARNERS_COMPARATOR_CHOICES;
+extern const Int DEFAULT_WARNERS_COMPARATOR_CHOICE;
+
+extern const Int DEFAULT_SHARE_SUBSUM_CHOICE;
+extern const Int DEFAULT_SHARE_LHS_CHOICE;
+extern const Int DEFAULT_GROUP_COEFFICIENT_CHOICE;
+extern const Int DEFAULT_SATURATE_CHOICE;
+extern const Int COEFFICIENT_GROUP_MIN_SIZE;
+
+extern const Int DEFAULT_HYBRID_THRESHOLD_CHOICE;
+extern const Int HYBRID_BLOCK_SIZE;
+
+extern const Int DEFAULT_CARDINALITY_NETWORK_CHOICE;
+extern const Int DEFAULT_AT_MOST_ONE_CHOICE;
+extern const Int AT_MOST_ONE_PAIRWISE_SIZE;
+extern const Int DEFAULT_PRIME_IMPLICATE_CHOICE;
+extern const Int PRIME_IMPLICATE_MAX_CLAUSES;
+extern const Int DEFAULT_XOR_OUTPUT_CHOICE;
+extern const Int DEFAULT_INDEPENDENT_SUPPORT_CHOICE;
+extern const Int INDEPENDENT_SUPPORT_LINE_SIZE;
+
+extern const vector<Int> MIXED_RADIX_BASES;
+extern const std::map<Int, vector<Pair<Int, Int> > > SORTING_NETWORKS;
+
 extern const Int DEFAULT_RANDOM_SEED;
 
 extern const vector<Int> VERBOSITY_LEVEL_CHOICES;
@@ -153,7 +196,7 @@ Int getPbfVar(Int literal);
 void formatConstraint(vector<Int>& clause, vector<Int>& coefficient, Int& limit);
 void inverseConstraint(vector<Int>& clause, vector<Int>& coefficient, Int& limit);
 
-void printConstraint(const vector<Int>& clause, const vector<Int>& coefficent, const Int& limit);
+void printConstraint(const vector<Int>& clause, const vector<Int>& coefficent, const Int& limit, const Int& lowerLimit = 0);
 void printPbf(const vector<vector<Int>>& clauses, const vector<vector<Int>>& coefficents, const vector<Int>& limits);
 
 /* functions: timing ********************************************************/